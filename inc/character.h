@@ -13,13 +13,15 @@ typedef struct {
     Color color;           // Color of the character
     float shootCooldown;   // Cooldown time between shots
     float shootTimer;      // Current timer for shooting cooldown
+    ProjectileType weapon; // Projectile type fired by the player
 } Character;
 
 // Function declarations
 void InitCharacter(Character *character);
 void UpdateCharacter(Character *character, float deltaTime);
+void MoveCharacter(Character *character, EcsWorld *world, Vector3 moveDirection);
 void DrawCharacter(Character *character);
-void ShootPlayerProjectile(Character *character, Projectile *projectiles, int projectileCount, 
-                           Camera3D *camera, Vector2 mousePosition);
+bool GetMouseGroundPoint(Camera3D *camera, Vector2 mousePosition, Vector3 *groundPoint);
+void ShootPlayerProjectile(Character *character, EcsWorld *world, Vector3 targetPoint);
 
 #endif // CHARACTER_H 
\ No newline at end of file
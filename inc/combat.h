@@ -0,0 +1,20 @@
+#ifndef COMBAT_H
+#define COMBAT_H
+
+#include "character.h"
+#include "enemy.h"
+
+#define HIT_RADIUS 0.5f        // Radius of a body's hit sphere, centred 1 unit above its feet
+
+// Per-tick inputs of the hit systems
+typedef struct {
+    Character *player;
+    bool openWorld;            // Killed enemies respawn around the player instead of in the arena
+} HitContext;
+
+// Function declarations
+void UpdateProjectileHits(EcsWorld *world, HitContext *context, ComponentMask skip);
+bool ResolveProjectileHit(EcsWorld *world, Entity projectile, ProjectileType type, Entity target,
+                          const HitContext *context);
+
+#endif // COMBAT_H 
\ No newline at end of file
@@ -0,0 +1,123 @@
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include "common.h"
+#include <stdint.h>
+
+// Projectile types: X(name, motion kernel, hit kernel, extra components).
+// Every type gets its own tag, and so its own archetype pool made of the
+// shared projectile components, the tag and its extra components, plus a
+// flight and a hit kernel specialised on its parameters (see projectile.h).
+// Types carrying a Forecast fly in straight lines and have their hits
+// predicted by the collision schedule instead of tested every tick (see
+// schedule.h).
+#define PROJECTILE_KIND_LIST(X) \
+    X(ENEMY,    Straight, Player,   COMPONENT_BIT(COMPONENT_FORECAST)) \
+    X(PLAYER,   Straight, Enemies,  COMPONENT_BIT(COMPONENT_FORECAST)) \
+    X(HOMING,   Homing,   Enemies,  COMPONENT_BIT(COMPONENT_HOMING)) \
+    X(SPREAD,   Decaying, Enemies,  0) \
+    X(PIERCING, Straight, Piercing, COMPONENT_BIT(COMPONENT_PIERCE) | COMPONENT_BIT(COMPONENT_FORECAST))
+
+typedef enum {
+#define X(name, motion, hit, extra) PROJECTILE_##name,
+    PROJECTILE_KIND_LIST(X)
+#undef X
+    PROJECTILE_TYPE_COUNT
+} ProjectileType;
+
+// Plain vector components
+typedef Vector3 Position;  // World position (feet of the body)
+typedef Vector3 Velocity;  // Displacement applied per tick
+typedef Vector3 Extent;    // Size of the body's bounding box
+
+// Steering behaviour parameters and accumulated force
+typedef struct {
+    Vector3 force;          // Accumulated steering force
+    float maxSpeed;         // Maximum movement speed
+    float maxForce;         // Maximum steering force
+    float separationRadius; // Radius to maintain separation from neighbours
+} Steering;
+
+typedef struct {
+    float current;
+    float max;
+} Health;
+
+typedef struct {
+    Color color;
+} Renderable;
+
+// Periodic shooting
+typedef struct {
+    float timer;     // Time since last shot
+    float interval;  // Time between shots
+} Shooter;
+
+// Projectile flight state. Everything constant per type lives in the
+// projectileKinds table instead.
+typedef struct {
+    Vector3 direction;
+    float lifetime;      // How long the projectile has lived
+} Projectile;
+
+// Target a homing projectile steers toward, 0 while it has none
+typedef struct {
+    uint32_t target;
+} Homing;
+
+#define MAX_PIERCE 3     // Most enemies a piercing projectile passes through before stopping
+
+// Enemies a piercing projectile has passed through, each hit only once
+typedef struct {
+    uint32_t hit[MAX_PIERCE + 1];
+    int hits;
+} Pierce;
+
+// Linear motion published for others to extrapolate. Republished whenever the
+// body strays too far from it, which invalidates predictions made against it.
+typedef struct {
+    Vector3 origin;      // Position when published
+    Vector3 velocity;    // Displacement per tick
+    long tick;           // Tick the motion was published on
+    uint32_t version;    // Bumped on every publish, 0 before the first
+} Track;
+
+// Contact predictions made for a projectile; events of an older version are stale
+typedef struct {
+    long until;          // Last tick its predictions cover
+    uint32_t version;    // 0 until the projectile is first predicted
+} Forecast;
+
+// Component registry: X(id, storage type). Tags carry no data and only take
+// part in archetype masks.
+#define COMPONENT_LIST(X) \
+    X(COMPONENT_POSITION,   Position) \
+    X(COMPONENT_VELOCITY,   Velocity) \
+    X(COMPONENT_EXTENT,     Extent) \
+    X(COMPONENT_STEERING,   Steering) \
+    X(COMPONENT_HEALTH,     Health) \
+    X(COMPONENT_RENDERABLE, Renderable) \
+    X(COMPONENT_SHOOTER,    Shooter) \
+    X(COMPONENT_PROJECTILE, Projectile) \
+    X(COMPONENT_HOMING,     Homing) \
+    X(COMPONENT_PIERCE,     Pierce) \
+    X(COMPONENT_TRACK,      Track) \
+    X(COMPONENT_FORECAST,   Forecast)
+
+#define TAG_LIST(X) \
+    X(TAG_ENEMY)
+
+typedef enum {
+#define X(id, type) id,
+    COMPONENT_LIST(X)
+#undef X
+#define X(id) id,
+    TAG_LIST(X)
+#undef X
+#define X(name, motion, hit, extra) TAG_SHOT_##name,
+    PROJECTILE_KIND_LIST(X)
+#undef X
+    COMPONENT_COUNT
+} ComponentId;
+
+#endif // COMPONENTS_H
@@ -0,0 +1,134 @@
+#ifndef ECS_H
+#define ECS_H
+
+#include "components.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Archetype entity-component store.
+//
+// Entities sharing the same set of components live in the same archetype.
+// Each archetype stores its entities in fixed-size, cache-line-aligned chunks
+// holding one tightly packed column per component, so systems walk plain
+// arrays instead of chasing per-entity structs. Chunks of an archetype are
+// kept dense: every chunk but the last is full.
+
+#define ECS_CHUNK_SIZE 16384        // Bytes per chunk, header included
+#define ECS_CACHE_LINE 64           // Alignment of chunks and columns
+#define ECS_MAX_ARCHETYPES 64
+#define ECS_MAX_COMPONENT_SIZE 64   // Largest component a deferred command can carry
+
+#define ECS_INDEX_BITS 20
+#define ECS_INDEX_MASK ((1u << ECS_INDEX_BITS) - 1)
+#define ECS_NULL_ENTITY 0u
+
+#define COMPONENT_BIT(id) ((ComponentMask)1u << (id))
+
+typedef uint32_t ComponentMask;
+_Static_assert(COMPONENT_COUNT <= 32, "components and tags must fit in a ComponentMask");
+typedef uint32_t Entity;           // Generation in the high bits, slot index in the low bits
+
+typedef struct EcsArchetype EcsArchetype;
+
+// Chunk header. Columns start at the next cache line.
+typedef struct {
+    EcsArchetype *archetype;
+    int count;
+} EcsChunk;
+
+struct EcsArchetype {
+    ComponentMask mask;
+    int capacity;                              // Entities per chunk
+    int columnOffset[COMPONENT_COUNT];         // Byte offset of each column, -1 if absent
+    int entityOffset;                          // Byte offset of the entity id column
+    EcsChunk **chunks;
+    int chunkCount;
+    int chunkCapacity;
+    EcsChunk *spare;                           // Emptied chunk kept for reuse
+    int entityCount;
+};
+
+typedef struct {
+    int archetype;       // Archetype index, -1 when the slot is free
+    int chunk;
+    int row;
+    uint32_t generation;
+} EcsRecord;
+
+typedef enum {
+    ECS_CMD_SPAWN,
+    ECS_CMD_DESTROY,
+    ECS_CMD_ADD,
+    ECS_CMD_REMOVE
+} EcsCommandType;
+
+// Deferred structural change, applied by EcsFlush
+typedef struct {
+    EcsCommandType type;
+    Entity entity;
+    ComponentMask mask;          // Spawn mask, or the single component to add/remove
+    size_t dataOffset;           // Start of the payload in the command data buffer
+} EcsCommand;
+
+typedef struct {
+    EcsArchetype archetypes[ECS_MAX_ARCHETYPES];
+    int archetypeCount;
+
+    EcsRecord *records;
+    int recordCount;
+    int recordCapacity;
+    int *freeSlots;
+    int freeCount;
+    int freeCapacity;
+
+    EcsCommand *commands;
+    int commandCount;
+    int commandCapacity;
+    unsigned char *commandData;
+    size_t commandDataSize;
+    size_t commandDataCapacity;
+
+    int iterating;               // Nesting depth of running systems
+} EcsWorld;
+
+// Chunk-by-chunk iteration over the archetypes matching a query
+typedef struct {
+    EcsWorld *world;
+    ComponentMask all;           // Components that must be present
+    ComponentMask none;          // Components that must be absent
+    int archetype;
+    int chunk;
+    EcsChunk *current;
+    int count;                   // Entities in the current chunk
+} EcsIter;
+
+typedef void (*EcsSystem)(EcsWorld *world, EcsIter *it, void *context);
+
+// Function declarations
+void EcsInitWorld(EcsWorld *world);
+void EcsFreeWorld(EcsWorld *world);
+
+Entity EcsSpawn(EcsWorld *world, ComponentMask mask);
+void EcsDestroy(EcsWorld *world, Entity entity);
+void EcsAddComponent(EcsWorld *world, Entity entity, ComponentId component, const void *data);
+void EcsRemoveComponent(EcsWorld *world, Entity entity, ComponentId component);
+bool EcsIsAlive(EcsWorld *world, Entity entity);
+bool EcsHas(EcsWorld *world, Entity entity, ComponentId component);
+void *EcsGet(EcsWorld *world, Entity entity, ComponentId component);
+
+void *EcsDeferSpawn(EcsWorld *world, ComponentMask mask);
+void *EcsSpawnComponent(void *spawn, ComponentMask mask, ComponentId component);
+void EcsDeferDestroy(EcsWorld *world, Entity entity);
+void EcsDeferAdd(EcsWorld *world, Entity entity, ComponentId component, const void *data);
+void EcsDeferRemove(EcsWorld *world, Entity entity, ComponentId component);
+int EcsCountDeferredSpawns(EcsWorld *world, ComponentMask all, ComponentMask none);
+void EcsFlush(EcsWorld *world);
+
+EcsIter EcsQuery(EcsWorld *world, ComponentMask all, ComponentMask none);
+bool EcsIterNext(EcsIter *it);
+void *EcsColumn(EcsIter *it, ComponentId component);
+Entity *EcsEntities(EcsIter *it);
+void EcsRunSystem(EcsWorld *world, ComponentMask all, ComponentMask none, EcsSystem system, void *context);
+int EcsCount(EcsWorld *world, ComponentMask all, ComponentMask none);
+
+#endif // ECS_H
@@ -4,29 +4,27 @@
 #include "projectile.h"
 
 #define MIN_DISTANCE_TO_SHOOT 15.0f
+#define RESPAWN_MIN_DISTANCE 10.0f      // Open world: nearest to the player a killed enemy comes back
+#define RESPAWN_MAX_DISTANCE 20.0f
 
-// Enemy structure
-typedef struct {
-    Vector3 position;      // 3D position
-    Vector3 size;          // Size of the enemy
-    Vector3 velocity;      // Current velocity
-    Vector3 steeringForce; // Accumulated steering force
-    float health;          // Enemy health
-    float speed;           // Maximum movement speed
-    float maxForce;        // Maximum steering force
-    float separationRadius; // Radius to maintain separation from other enemies
-    Color color;           // Color of the enemy
-    float shootTimer;      // Timer for shooting
-    float shootInterval;   // Time between shots
-} Enemy;
+// Components every enemy entity carries
+#define ENEMY_MASK (COMPONENT_BIT(COMPONENT_POSITION) | COMPONENT_BIT(COMPONENT_VELOCITY) | \
+                    COMPONENT_BIT(COMPONENT_EXTENT) | COMPONENT_BIT(COMPONENT_STEERING) | \
+                    COMPONENT_BIT(COMPONENT_HEALTH) | COMPONENT_BIT(COMPONENT_RENDERABLE) | \
+                    COMPONENT_BIT(COMPONENT_SHOOTER) | COMPONENT_BIT(COMPONENT_TRACK) | \
+                    COMPONENT_BIT(TAG_ENEMY))
 
 // Function declarations
-void InitEnemies(Enemy *enemies, int count, Vector3 playerPos);
-void UpdateEnemies(Enemy *enemies, int count, Vector3 playerPos, Projectile *projectiles, int projectileCount, float deltaTime);
-void DrawEnemies(Enemy *enemies, int count);
-Vector3 CalculateSteeringForce(Enemy *enemy, Enemy *enemies, int count, int ownIndex, Vector3 playerPos);
-Vector3 SeekForce(Enemy *enemy, Vector3 targetPos);
-Vector3 SeparationForce(Enemy *enemy, Enemy *enemies, int count, int ownIndex);
-Vector3 RandomForce(Enemy *enemy);
+void InitEnemies(EcsWorld *world, int count, Vector3 playerPos);
+Entity SpawnEnemy(EcsWorld *world, Vector3 position);
+void UpdateEnemies(EcsWorld *world, Vector3 playerPos, Vector3 playerSize, float deltaTime);
+void DrawEnemies(EcsWorld *world);
+void DamageEnemy(EcsWorld *world, Entity enemy, float damage, Vector3 playerPos, bool openWorld);
+Vector3 CalculateSteeringForce(EcsWorld *world, Entity self, Vector3 position, Vector3 velocity,
+                               const Steering *steering, Vector3 playerPos);
+Vector3 SeekForce(Vector3 position, Vector3 velocity, float maxSpeed, Vector3 targetPos);
+Vector3 SeparationForce(EcsWorld *world, Entity self, Vector3 position, Vector3 velocity,
+                        const Steering *steering);
+Vector3 RandomForce(void);
 
 #endif // ENEMY_H 
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include "character.h"
+#include "combat.h"
+#include "enemy.h"
+#include "projectile.h"
+#include "schedule.h"
+#include "worldmap.h"
+
+// Player intent for one tick, filled from the keyboard/mouse or by a bot
+typedef struct {
+    Vector3 moveDirection;   // Isometric movement, not necessarily normalized
+    bool shoot;              // Trigger pulled this tick
+    Vector3 aimPoint;        // Ground point to shoot at
+    bool switchWeapon;       // Select `weapon` before shooting
+    ProjectileType weapon;
+} PlayerInput;
+
+// Simulation state, independent of the window and renderer
+typedef struct {
+    Character player;
+    EcsWorld world;
+    WorldMap map;            // Streamed open world, inactive when it could not be opened
+    bool streaming;
+    CollisionSchedule schedule;
+    bool scheduledHits;      // Predict straight shots' hits instead of testing them every tick
+    long tick;               // Number of updates run so far
+    float time;              // Simulated seconds
+} Game;
+
+// Function declarations
+void InitGame(Game *game, const char *worldPath, bool resetWorld, unsigned int seed);
+void UpdateGame(Game *game, const PlayerInput *input, float deltaTime);
+void FreeGame(Game *game);
+
+#endif // GAME_H 
\ No newline at end of file
@@ -0,0 +1,66 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "components.h"
+#include "telemetry.h"
+
+// Game metrics: X(id, kind, name, labels, help). Metrics sharing a name must
+// be listed next to each other so the exporter writes their header once.
+#define GAME_METRIC_LIST(X) \
+    X(METRIC_TICK_SECONDS,       TELEMETRY_HISTOGRAM, "game_tick_seconds", "", \
+      "Wall time spent in one simulation tick") \
+    X(METRIC_ENEMIES_LIVE,       TELEMETRY_GAUGE,     "game_enemies_live", "", \
+      "Enemies currently simulated") \
+    X(METRIC_PROJECTILES_LIVE,   TELEMETRY_GAUGE,     "game_projectiles_live", "", \
+      "Projectiles currently in flight across all pools") \
+    X(METRIC_BROADPHASE_PAIRS,   TELEMETRY_COUNTER,   "game_broadphase_pairs_tested_total", "", \
+      "Projectile-target pairs tested for overlap") \
+    X(METRIC_BROADPHASE_HITS,    TELEMETRY_COUNTER,   "game_broadphase_hits_total", "", \
+      "Projectile-target pairs found overlapping") \
+    X(METRIC_SHOTS_PLAYER,       TELEMETRY_COUNTER,   "game_shots_fired_total", "shooter=\"player\"", \
+      "Trigger pulls that fired at least one projectile") \
+    X(METRIC_SHOTS_ENEMY,        TELEMETRY_COUNTER,   "game_shots_fired_total", "shooter=\"enemy\"", "") \
+    X(METRIC_REJECTED_PLAYER,    TELEMETRY_COUNTER,   "game_shots_rejected_total", \
+      "shooter=\"player\",reason=\"cooldown\"", "Attempts to fire that launched no projectile") \
+    X(METRIC_REJECTED_PLAYER_POOL, TELEMETRY_COUNTER,  "game_shots_rejected_total", \
+      "shooter=\"player\",reason=\"pool_full\"", "") \
+    X(METRIC_REJECTED_ENEMY,     TELEMETRY_COUNTER,   "game_shots_rejected_total", \
+      "shooter=\"enemy\",reason=\"pool_full\"", "") \
+    X(METRIC_CONTACT_PREDICTIONS, TELEMETRY_COUNTER,   "game_contact_predictions_total", "", \
+      "Projectile-target pairs solved for their closest approach") \
+    X(METRIC_TRACK_PUBLISHES,    TELEMETRY_COUNTER,   "game_track_publishes_total", "", \
+      "Target motions republished after straying, staling predictions against them") \
+    X(METRIC_CONTACT_EVENTS,     TELEMETRY_GAUGE,     "game_contact_events", "", \
+      "Events queued in the collision schedule") \
+    X(METRIC_RESPAWNS,           TELEMETRY_COUNTER,   "game_enemy_respawns_total", "", \
+      "Enemies killed and respawned") \
+    X(METRIC_CHUNK_LOADS,        TELEMETRY_COUNTER,   "game_chunk_loads_total", "", \
+      "World chunks rehydrated from the world file") \
+    X(METRIC_CHUNK_UNLOADS,      TELEMETRY_COUNTER,   "game_chunk_unloads_total", "", \
+      "World chunks parked into the world file") \
+    X(METRIC_ENEMIES_DROPPED,    TELEMETRY_COUNTER,   "game_enemies_dropped_total", "", \
+      "Enemies discarded because their chunk's world file slot was full") \
+    X(METRIC_PARKED_ENEMIES,     TELEMETRY_GAUGE,     "game_parked_enemies", "", \
+      "Enemies stored in the world file outside the active area")
+
+// Fixed metrics first, then one slot per projectile pool for each pool metric
+typedef enum {
+#define X(id, kind, name, labels, help) id,
+    GAME_METRIC_LIST(X)
+#undef X
+    METRIC_POOL_LIVE,                                              // + ProjectileType
+    METRIC_POOL_HIGH_WATER = METRIC_POOL_LIVE + PROJECTILE_TYPE_COUNT,
+    METRIC_POOL_FULL = METRIC_POOL_HIGH_WATER + PROJECTILE_TYPE_COUNT,
+    METRIC_COUNT = METRIC_POOL_FULL + PROJECTILE_TYPE_COUNT
+} MetricId;
+
+// Registry the game writes to. Points at private memory until published.
+extern TelemetryRegion *telemetry;
+
+#define METRIC(id) (&telemetry->metrics[(id)])
+
+// Function declarations
+void InitMetrics(void);
+void FreeMetrics(void);
+
+#endif // METRICS_H
\ No newline at end of file
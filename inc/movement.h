@@ -0,0 +1,15 @@
+#ifndef MOVEMENT_H
+#define MOVEMENT_H
+
+#include "ecs.h"
+
+// Components of an entity that moves as a solid body
+#define BODY_MASK (COMPONENT_BIT(COMPONENT_POSITION) | COMPONENT_BIT(COMPONENT_VELOCITY) | \
+                   COMPONENT_BIT(COMPONENT_EXTENT))
+
+// Function declarations
+void UpdateMovement(EcsWorld *world, Vector3 playerPos, Vector3 playerSize);
+Vector3 ResolveBodyCollisions(EcsWorld *world, Entity self, Vector3 currentPos, Vector3 newPos,
+                              Vector3 size, bool *collided);
+
+#endif // MOVEMENT_H 
\ No newline at end of file
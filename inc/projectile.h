@@ -1,33 +1,78 @@
 #ifndef PROJECTILE_H
 #define PROJECTILE_H
 
-#include "common.h"
+#include "ecs.h"
 
-#define MAX_PROJECTILES 100
+#define MAX_PROJECTILES 100    // Capacity of each projectile type's pool
 
-typedef enum {
-    PROJECTILE_ENEMY,
-    PROJECTILE_PLAYER
-} ProjectileType;
+// Components every projectile entity carries
+#define PROJECTILE_MASK (COMPONENT_BIT(COMPONENT_POSITION) | COMPONENT_BIT(COMPONENT_PROJECTILE))
 
+// Archetype of each type's pool: the shared components, the type's tag and
+// the extra components listed in PROJECTILE_KIND_LIST
+enum {
+#define X(name, motion, hit, extra) \
+    PROJECTILE_MASK_##name = PROJECTILE_MASK | COMPONENT_BIT(TAG_SHOT_##name) | (extra),
+    PROJECTILE_KIND_LIST(X)
+#undef X
+};
+
+// Parameters shared by every projectile of a type
 typedef struct {
-    Vector3 position;
-    Vector3 direction;
-    float speed;
+    const char *name;
+    ComponentMask mask;    // Archetype of the type's pool
+    float speed;           // Units per tick
     float radius;
+    float maxLifetime;     // Seconds
+    float damage;
     Color color;
-    bool active;
-    float lifetime;      // How long the projectile lives
-    float maxLifetime;   // Maximum lifetime in seconds
-    ProjectileType type; // Who fired the projectile
-} Projectile;
+    float turnRate;        // Homing: fraction of the way turned toward the target per tick
+    int pierce;            // Piercing: enemies passed through before stopping, at most MAX_PIERCE
+    int pellets;           // Projectiles per trigger pull
+    float spreadAngle;     // Fan width across all pellets, in radians
+} ProjectileKind;
+
+// Defined in the header so every kernel sees its type's parameters as constants
+static const ProjectileKind projectileKinds[PROJECTILE_TYPE_COUNT] = {
+    [PROJECTILE_ENEMY] = {
+        .name = "Enemy",
+        .mask = PROJECTILE_MASK_ENEMY,
+        .speed = 0.3f, .radius = 0.2f, .maxLifetime = 3.0f, .damage = 0.0f,
+        .color = ORANGE, .pellets = 1
+    },
+    [PROJECTILE_PLAYER] = {
+        .name = "Blaster",
+        .mask = PROJECTILE_MASK_PLAYER,
+        .speed = 0.5f, .radius = 0.2f, .maxLifetime = 3.0f, .damage = 25.0f,
+        .color = YELLOW, .pellets = 1
+    },
+    [PROJECTILE_HOMING] = {
+        .name = "Homing",
+        .mask = PROJECTILE_MASK_HOMING,
+        .speed = 0.35f, .radius = 0.25f, .maxLifetime = 4.0f, .damage = 20.0f,
+        .color = LIME, .turnRate = 0.08f, .pellets = 1
+    },
+    [PROJECTILE_SPREAD] = {
+        .name = "Spread",
+        .mask = PROJECTILE_MASK_SPREAD,
+        .speed = 0.6f, .radius = 0.15f, .maxLifetime = 0.8f, .damage = 10.0f,
+        .color = GOLD, .pellets = 5, .spreadAngle = 30.0f * DEG2RAD
+    },
+    [PROJECTILE_PIERCING] = {
+        .name = "Piercing",
+        .mask = PROJECTILE_MASK_PIERCING,
+        .speed = 0.8f, .radius = 0.15f, .maxLifetime = 2.0f, .damage = 25.0f,
+        .color = SKYBLUE, .pierce = MAX_PIERCE, .pellets = 1
+    }
+};
 
 // Function declarations
-void InitProjectiles(Projectile *projectiles, int count);
-void UpdateProjectiles(Projectile *projectiles, int count, float deltaTime);
-void DrawProjectiles(Projectile *projectiles, int count);
-void ShootProjectile(Projectile *projectiles, int count, Vector3 position, Vector3 target);
-bool CheckProjectileCollision(Projectile projectile, Vector3 targetPosition, float targetRadius);
-int CountActiveProjectiles(Projectile *projectiles, int count);
+bool SpawnProjectile(EcsWorld *world, Vector3 position, Vector3 direction, ProjectileType type);
+void UpdateProjectiles(EcsWorld *world, float deltaTime);
+void DrawProjectiles(EcsWorld *world);
+bool ShootProjectile(EcsWorld *world, Vector3 position, Vector3 target);
+bool CheckProjectileCollision(Vector3 projectilePosition, float projectileRadius,
+                              Vector3 targetPosition, float targetRadius);
+float ProjectilePoolOccupancy(EcsWorld *world);
 
 #endif // PROJECTILE_H 
\ No newline at end of file
@@ -0,0 +1,49 @@
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include "combat.h"
+
+// Event-driven collision detection for projectiles flying in straight lines.
+//
+// When such a projectile appears, the time of closest approach to every
+// target it can hit is solved analytically from the target's published Track,
+// and the ticks where they might touch are queued as a contact event. Only
+// due events are tested, so projectiles far from everything cost nothing per
+// tick. A target that strays from its Track republishes it, which stales the
+// events predicted against it and re-predicts that target alone.
+
+#define CONTACT_TOLERANCE 0.25f   // How far a target may stray from its Track before republishing
+#define CONTACT_SLACK 0.01f       // Absorbs drift between stepped and analytic flight
+#define CONTACT_HORIZON 120       // Ticks predicted ahead before a projectile is predicted again
+
+typedef enum {
+    CONTACT_WINDOW,               // Projectile and target may overlap from `tick` through `last`
+    CONTACT_HORIZON_END           // Predictions for the projectile run out
+} CollisionEventType;
+
+typedef struct {
+    long tick;                    // Tick the event is due
+    long last;                    // Last tick of a contact window
+    Entity projectile;
+    Entity target;                // Enemy hit, ECS_NULL_ENTITY for the player
+    uint32_t forecast;            // Projectile's Forecast version when predicted
+    uint32_t track;               // Target's Track version when predicted
+    uint8_t projectileType;
+    uint8_t type;
+} CollisionEvent;
+
+typedef struct {
+    CollisionEvent *events;       // Binary min-heap on tick
+    int count;
+    int capacity;
+    Track player;                 // The player is not an entity, so its Track lives here
+    Vector3 playerLast;           // Player position on the previous tick
+} CollisionSchedule;
+
+// Function declarations
+void InitCollisionSchedule(CollisionSchedule *schedule);
+void FreeCollisionSchedule(CollisionSchedule *schedule);
+void UpdateCollisionSchedule(CollisionSchedule *schedule, EcsWorld *world, const HitContext *hitContext, long tick,
+                             float deltaTime);
+
+#endif // SCHEDULE_H
\ No newline at end of file
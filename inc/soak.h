@@ -0,0 +1,42 @@
+#ifndef SOAK_H
+#define SOAK_H
+
+#include "game.h"
+
+#define SOAK_WINDOW 4096          // Ticks in the rolling tick-time window
+#define SOAK_ROAM_RADIUS 300.0f   // Radius of the bot's tour through a streamed world
+#define SOAK_ROAM_PERIOD 600.0f   // Seconds per lap
+
+// Process exit codes of a soak run
+#define SOAK_EXIT_OK 0
+#define SOAK_EXIT_THRESHOLD 1
+#define SOAK_EXIT_USAGE 2
+
+typedef enum {
+    SOAK_ARGS_NONE,               // No soak requested, run the game normally
+    SOAK_ARGS_OK,
+    SOAK_ARGS_ERROR
+} SoakArgsResult;
+
+// Headless soak run configuration. Thresholds below zero are disabled.
+typedef struct {
+    float duration;               // Simulated seconds to run
+    float tickRate;               // Fixed updates per simulated second
+    float sampleInterval;         // Simulated seconds between time-series rows
+    float warmup;                 // Simulated seconds before thresholds and baselines apply
+    const char *outputPath;       // Time-series file, NULL to skip
+    const char *worldPath;        // Scratch world file, recreated for every run
+    unsigned int seed;
+    bool scheduledHits;           // Collision schedule on, off to compare with per-tick testing
+    double maxP99Ms;              // Rolling p99 tick time
+    double maxP999Ms;             // Rolling p99.9 tick time
+    double maxRssGrowthKb;        // RSS growth since the end of warmup
+    double maxEntityDrift;        // Change in mean live entities since warmup
+    double maxPoolOccupancy;      // Mean fill of the fullest projectile pool over a sample
+} SoakConfig;
+
+// Function declarations
+SoakArgsResult ParseSoakArgs(int argc, char **argv, SoakConfig *config);
+int RunSoak(const SoakConfig *config);
+
+#endif // SOAK_H 
\ No newline at end of file
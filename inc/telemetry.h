@@ -0,0 +1,81 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Lock-free counter, gauge and histogram registry living in a shared memory
+// segment. The game updates it with relaxed atomics; a separate process maps
+// the same segment read-only and samples it without stopping the game. Metric
+// names and help live in the segment, so readers need no game headers.
+
+#define TELEMETRY_MAGIC 0x5447574Eu           // "NWGT"
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_SHM_PREFIX "/not_working_game_exe."
+#define TELEMETRY_MAX_BUCKETS 12
+#define TELEMETRY_SUM_SCALE 1000000.0         // Histogram sums are kept in millionths
+
+_Static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "shared counters need lock-free 64-bit atomics");
+
+typedef enum {
+    TELEMETRY_COUNTER,
+    TELEMETRY_GAUGE,
+    TELEMETRY_HISTOGRAM
+} TelemetryKind;
+
+typedef struct {
+    char name[48];
+    char labels[64];                          // Prometheus label pairs without braces, may be empty
+    char help[96];
+    uint32_t kind;
+    uint32_t bucketCount;
+    double bounds[TELEMETRY_MAX_BUCKETS];     // Histogram bucket upper bounds, +Inf is implicit
+    _Atomic int64_t value;                    // Counter or gauge value, histogram observation count
+    _Atomic int64_t sum;                      // Histogram sum, scaled by TELEMETRY_SUM_SCALE
+    _Atomic int64_t buckets[TELEMETRY_MAX_BUCKETS + 1];
+} TelemetryMetric;
+
+typedef struct {
+    _Atomic uint32_t magic;                   // TELEMETRY_MAGIC once every metric is defined
+    uint32_t version;
+    int32_t pid;
+    uint32_t metricCount;
+    int64_t startTime;                        // Unix seconds
+    TelemetryMetric metrics[];
+} TelemetryRegion;
+
+// Function declarations
+TelemetryRegion *TelemetryCreate(int metricCount, char *path, size_t pathSize);
+void TelemetryPublish(TelemetryRegion *region);
+void TelemetryUnpublish(TelemetryRegion *region, const char *path);
+TelemetryRegion *TelemetryAttach(int pid);
+void TelemetryDetach(TelemetryRegion *region);
+void TelemetryDefine(TelemetryMetric *metric, TelemetryKind kind, const char *name, const char *labels,
+                     const char *help, const double *bounds, int bucketCount);
+void TelemetryObserve(TelemetryMetric *metric, double value);
+void TelemetryWritePrometheus(const TelemetryRegion *region, FILE *out);
+
+static inline void TelemetryAdd(TelemetryMetric *metric, int64_t amount) {
+    atomic_fetch_add_explicit(&metric->value, amount, memory_order_relaxed);
+}
+
+static inline void TelemetrySet(TelemetryMetric *metric, int64_t value) {
+    atomic_store_explicit(&metric->value, value, memory_order_relaxed);
+}
+
+// Raise a high-water mark
+static inline void TelemetryMax(TelemetryMetric *metric, int64_t value) {
+    int64_t current = atomic_load_explicit(&metric->value, memory_order_relaxed);
+    while (value > current &&
+           !atomic_compare_exchange_weak_explicit(&metric->value, &current, value,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+static inline int64_t TelemetryGet(const TelemetryMetric *metric) {
+    return atomic_load_explicit((_Atomic int64_t *)&metric->value, memory_order_relaxed);
+}
+
+#endif // TELEMETRY_H 
\ No newline at end of file
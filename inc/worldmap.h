@@ -0,0 +1,87 @@
+#ifndef WORLDMAP_H
+#define WORLDMAP_H
+
+#include "ecs.h"
+
+// Chunked open world. Only chunks within ACTIVE_CHUNK_RADIUS of the player
+// are simulated; enemies elsewhere are compressed into fixed-size slots of a
+// memory-mapped world file and rehydrated when the player comes back. An
+// active chunk simulates at most MAX_LIVE_PER_CHUNK enemies, the player's chunk
+// and its neighbours MAX_LIVE_AROUND_PLAYER between them, and the farthest from
+// the player are parked, so the live population stays bound to the active area.
+
+#define WORLD_FILE "world.nwg"
+#define WORLD_FILE_VERSION 1
+
+#define CHUNK_CELLS 16                                   // Cells along a chunk side
+#define CHUNK_SIZE (CHUNK_CELLS * CELL_SIZE)             // World units along a chunk side
+#define WORLD_CHUNKS 256                                 // Chunks along a world side
+#define WORLD_HALF_EXTENT (WORLD_CHUNKS * CHUNK_SIZE / 2)
+#define ACTIVE_CHUNK_RADIUS 2                            // Chebyshev radius of simulated chunks
+#define MAX_ACTIVE_CHUNKS ((2 * ACTIVE_CHUNK_RADIUS + 3) * (2 * ACTIVE_CHUNK_RADIUS + 3))
+#define STREAM_BUDGET 2                                  // Chunk loads plus unloads per tick
+#define MAX_GENERATED_ENEMIES 3                          // Enemies placed in a fresh chunk
+
+#define TILE_CHUNKS 4                                    // A tile of 4x4 chunk slots fills one page
+#define CHUNK_SLOT_SIZE 256
+#define TILE_SIZE (TILE_CHUNKS * TILE_CHUNKS * CHUNK_SLOT_SIZE)
+#define MAX_PARKED_PER_CHUNK 31
+#define MAX_LIVE_PER_CHUNK 8                             // Enemies simulated at once in an active chunk
+#define MAX_LIVE_AROUND_PLAYER (9 * MAX_LIVE_PER_CHUNK)  // Shared by the player's chunk and its neighbours
+
+// Enemy compressed to 8 bytes while its chunk is inactive
+typedef struct {
+    uint16_t x;              // Position inside the chunk, 1/65536 of CHUNK_SIZE
+    uint16_t z;
+    uint8_t health;          // Fraction of max health, 0-255
+    uint8_t shootTimer;      // Tenths of a second
+    uint8_t shootInterval;   // Seconds
+    uint8_t flags;
+} ParkedEnemy;
+
+#define PARKED_HIT 0x01      // Enemy shows the hit tint
+
+typedef struct {
+    uint16_t count;
+    uint16_t flags;
+    uint32_t reserved;
+    ParkedEnemy enemies[MAX_PARKED_PER_CHUNK];
+} ChunkSlot;
+
+#define CHUNK_GENERATED 0x01 // Slot holds the chunk's real contents
+
+// First page of the world file
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t chunksPerSide;
+    uint32_t chunkCells;
+    uint32_t slotSize;
+    uint64_t seed;
+    int64_t parkedCount;     // Enemies currently parked across all chunks
+} WorldFileHeader;
+
+typedef struct {
+    int x;
+    int z;
+} ChunkCoord;
+
+typedef struct {
+    int fd;
+    unsigned char *base;     // Mapped world file
+    size_t size;
+    WorldFileHeader *header;
+    ChunkCoord active[MAX_ACTIVE_CHUNKS];
+    int activeCount;
+    ChunkCoord center;       // Chunk the player stands in
+} WorldMap;
+
+// Function declarations
+bool OpenWorldMap(WorldMap *map, const char *path, bool reset, unsigned int seed);
+void CloseWorldMap(WorldMap *map, EcsWorld *world);
+void UpdateWorldStreaming(WorldMap *map, EcsWorld *world, Vector3 playerPos, int budget);
+void DrawWorldMap(WorldMap *map);
+ChunkCoord ChunkAt(Vector3 position);
+Vector3 ClampToWorld(Vector3 position);
+
+#endif // WORLDMAP_H 
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "character.h"
+#include "metrics.h"
+#include "movement.h"
 #include <raylib.h>
 
 // Initialize character
@@ -10,6 +12,7 @@ void InitCharacter(Character *character) {
     character->color = RED;
     character->shootCooldown = 0.2f; // 200ms between shots
     character->shootTimer = 0.0f;
+    character->weapon = PROJECTILE_PLAYER;
 }
 
 // Update character
@@ -21,83 +24,94 @@ void UpdateCharacter(Character *character, float deltaTime) {
     }
 }
 
+// Move character along a normalized direction, sliding around solid bodies
+void MoveCharacter(Character *character, EcsWorld *world, Vector3 moveDirection) {
+    // Calculate new position
+    Vector3 newPosition = character->position;
+    newPosition.x += moveDirection.x * character->speed;
+    newPosition.z += moveDirection.z * character->speed;
+    
+    // Get corrected position that doesn't collide with any enemy
+    character->position = ResolveBodyCollisions(world, ECS_NULL_ENTITY, character->position, newPosition,
+                                                character->size, NULL);
+}
+
 // Draw character
 void DrawCharacter(Character *character) {
     DrawCube(character->position, character->size.x, character->size.y, character->size.z, character->color);
     DrawCubeWires(character->position, character->size.x, character->size.y, character->size.z, BLACK);
 }
 
-// Shoot a projectile from player toward mouse position
-void ShootPlayerProjectile(Character *character, Projectile *projectiles, int projectileCount, 
-                          Camera3D *camera, Vector2 mousePosition) {
+// Find where the mouse ray hits the ground plane, false if it never does
+bool GetMouseGroundPoint(Camera3D *camera, Vector2 mousePosition, Vector3 *groundPoint) {
+    // Calculate ray from mouse position
+    Ray ray = GetMouseRay(mousePosition, *camera);
+    
+    // Ground plane is at y = 0, we need to calculate where the ray intersects it
+    // Ray-plane intersection formula: t = (planeD - dot(planeNormal, rayOrigin)) / dot(planeNormal, rayDirection)
+    // Where planeD = 0 (for y=0 plane) and planeNormal = (0,1,0)
+    
+    float t = -ray.position.y / ray.direction.y;
+    
+    // Check if ray is parallel to plane or going away from it
+    if (t <= 0) {
+        TraceLog(LOG_WARNING, "Ray does not intersect ground plane (parallel or wrong direction)");
+        return false;
+    }
+    
+    // Calculate intersection point
+    *groundPoint = (Vector3){
+        ray.position.x + ray.direction.x * t,
+        0.0f,
+        ray.position.z + ray.direction.z * t
+    };
+    
+    TraceLog(LOG_INFO, "Ray hit ground at: (%f, %f, %f)", 
+             groundPoint->x, groundPoint->y, groundPoint->z);
+    
+    return true;
+}
+
+// Shoot a projectile from player toward a point on the ground
+void ShootPlayerProjectile(Character *character, EcsWorld *world, Vector3 targetPoint) {
     // Check if player can shoot (cooldown elapsed)
     if (character->shootTimer <= 0) {
-        // Calculate ray from mouse position
-        Ray ray = GetMouseRay(mousePosition, *camera);
-        
-        // Ground plane is at y = 0, we need to calculate where the ray intersects it
-        // Ray-plane intersection formula: t = (planeD - dot(planeNormal, rayOrigin)) / dot(planeNormal, rayDirection)
-        // Where planeD = 0 (for y=0 plane) and planeNormal = (0,1,0)
+        // Set projectile position (slightly above character to match "gun" height)
+        Vector3 shootPos = character->position;
+        shootPos.y += character->size.y * 0.50f;
         
-        float t = -ray.position.y / ray.direction.y;
+        // Calculate direction from character to hit point
+        Vector3 direction = Vector3Subtract(targetPoint, shootPos);
         
-        // Check if ray is parallel to plane or going away from it
-        if (t <= 0) {
-            TraceLog(LOG_WARNING, "Ray does not intersect ground plane (parallel or wrong direction)");
-            return;
-        }
+        // Project onto XZ plane (set Y to 0)
+        direction.y = 0.0f;
         
-        // Calculate intersection point
-        Vector3 targetPoint = {
-            ray.position.x + ray.direction.x * t,
-            0.0f,
-            ray.position.z + ray.direction.z * t
-        };
+        direction = Vector3Normalize(direction);
         
-        TraceLog(LOG_INFO, "Ray hit ground at: (%f, %f, %f)", 
-                 targetPoint.x, targetPoint.y, targetPoint.z);
+        // Fan the weapon's pellets evenly across its spread angle
+        const ProjectileKind *kind = &projectileKinds[character->weapon];
+        bool fired = false;
+        for (int i = 0; i < kind->pellets; i++) {
+            float angle = kind->pellets > 1 ? kind->spreadAngle * ((float)i / (kind->pellets - 1) - 0.5f) : 0.0f;
+            Vector3 pelletDirection = {
+                direction.x * cosf(angle) - direction.z * sinf(angle),
+                0.0f,
+                direction.x * sinf(angle) + direction.z * cosf(angle)
+            };
+            
+            // Take a projectile from the weapon's pool
+            fired |= SpawnProjectile(world, shootPos, pelletDirection, character->weapon);
+        }
         
-        // Get an inactive projectile
-        for (int i = 0; i < projectileCount; i++) {
-            if (!projectiles[i].active) {
-                // Set projectile position (slightly above character to match "gun" height)
-                Vector3 shootPos = character->position;
-                shootPos.y += character->size.y * 0.50f;
-                
-                // Set initial position
-                projectiles[i].position = shootPos;
-                
-                // Calculate direction from character to hit point
-                Vector3 direction = Vector3Subtract(targetPoint, shootPos);
-                
-                // Project onto XZ plane (set Y to 0)
-                direction.y = 0.0f;
-                
-                // Ensure direction is normalized
-                projectiles[i].direction = Vector3Normalize(direction);
-                
-                // Make projectiles faster than enemy projectiles
-                projectiles[i].speed = 0.5f;
-                
-                // Set different color for player projectiles
-                projectiles[i].color = YELLOW;
-                
-                // Set type to player projectile
-                projectiles[i].type = PROJECTILE_PLAYER;
-                
-                // Reset lifetime
-                projectiles[i].lifetime = 0.0f;
-                
-                // Activate projectile
-                projectiles[i].active = true;
-                
-                // Start cooldown
-                character->shootTimer = character->shootCooldown;
-                
-                break;
-            }
+        if (fired) {
+            // Start cooldown
+            character->shootTimer = character->shootCooldown;
+            TelemetryAdd(METRIC(METRIC_SHOTS_PLAYER), 1);
+        } else {
+            TelemetryAdd(METRIC(METRIC_REJECTED_PLAYER_POOL), 1);
         }
     } else {
+        TelemetryAdd(METRIC(METRIC_REJECTED_PLAYER), 1);
         TraceLog(LOG_INFO, "Player tried to shoot but cooldown active: %.2f", character->shootTimer);
     }
 } 
\ No newline at end of file
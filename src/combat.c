@@ -0,0 +1,173 @@
+#include "combat.h"
+#include "metrics.h"
+
+//------------------------------------------------------------------------------------
+// Hit effects, shared by the per-tick kernels and the collision schedule. Each
+// returns true when the projectile is used up.
+//------------------------------------------------------------------------------------
+
+// Enemy shot reaching the player
+static inline bool ResolvePlayer(EcsWorld *world, Entity projectile, const ProjectileKind *kind, Entity target,
+                                 const HitContext *context) {
+    // Player hit by projectile
+    EcsDeferDestroy(world, projectile);
+    
+    // You could implement player health/damage here
+    // For example: player.health -= kind->damage;
+    return true;
+}
+
+// Player shot stopping at the first enemy it hits
+static inline bool ResolveEnemies(EcsWorld *world, Entity projectile, const ProjectileKind *kind, Entity enemy,
+                                  const HitContext *context) {
+    // Enemy hit by projectile
+    EcsDeferDestroy(world, projectile);
+    DamageEnemy(world, enemy, kind->damage, context->player->position, context->openWorld);
+    return true;
+}
+
+// Whether a piercing projectile already went through an enemy
+static inline bool AlreadyPierced(const Pierce *pierce, Entity enemy) {
+    for (int i = 0; i < pierce->hits; i++) {
+        if (pierce->hit[i] == enemy) return true;
+    }
+    return false;
+}
+
+// Player shot passing through a number of enemies before stopping
+static inline bool PierceEnemy(EcsWorld *world, Entity projectile, Pierce *pierce, const ProjectileKind *kind,
+                               Entity enemy, const HitContext *context) {
+    // Already stopped, waiting for the deferred destroy
+    if (pierce->hits > kind->pierce) return true;
+
+    // Ignore enemies we are passing or have passed through
+    if (AlreadyPierced(pierce, enemy)) return false;
+    
+    DamageEnemy(world, enemy, kind->damage, context->player->position, context->openWorld);
+    pierce->hit[pierce->hits] = enemy;
+    
+    if (++pierce->hits <= kind->pierce) return false;
+    EcsDeferDestroy(world, projectile);
+    return true;
+}
+
+static inline bool ResolvePiercing(EcsWorld *world, Entity projectile, const ProjectileKind *kind, Entity enemy,
+                                   const HitContext *context) {
+    return PierceEnemy(world, projectile, EcsGet(world, projectile, COMPONENT_PIERCE), kind, enemy, context);
+}
+
+// Apply a hit predicted by the collision schedule
+bool ResolveProjectileHit(EcsWorld *world, Entity projectile, ProjectileType type, Entity target,
+                          const HitContext *context) {
+    switch (type) {
+#define X(name, motion, hit, extra) \
+        case PROJECTILE_##name: \
+            return Resolve##hit(world, projectile, &projectileKinds[PROJECTILE_##name], target, context);
+        PROJECTILE_KIND_LIST(X)
+#undef X
+        default:
+            return false;
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Hit kernels, specialised per projectile type like the flight kernels
+//------------------------------------------------------------------------------------
+
+// Enemy shots against the player
+static inline void HitPlayer(EcsWorld *world, EcsIter *it, const ProjectileKind *kind, HitContext *context) {
+    Position *position = EcsColumn(it, COMPONENT_POSITION);
+    Entity *entities = EcsEntities(it);
+    Character *player = context->player;
+    Vector3 playerCenter = { player->position.x, player->position.y + 1.0f, player->position.z };
+    int hits = 0;
+    
+    for (int i = 0; i < it->count; i++) {
+        if (CheckProjectileCollision(position[i], kind->radius, playerCenter, HIT_RADIUS)) {
+            ResolvePlayer(world, entities[i], kind, ECS_NULL_ENTITY, context);
+            hits++;
+        }
+    }
+    
+    TelemetryAdd(METRIC(METRIC_BROADPHASE_PAIRS), it->count);
+    TelemetryAdd(METRIC(METRIC_BROADPHASE_HITS), hits);
+}
+
+// First enemy whose hit sphere a projectile overlaps, skipping those a piercing
+// projectile already went through. Pairs tested are added to *pairs so
+// callers can report them in one go.
+static Entity FindEnemyHit(EcsWorld *world, Vector3 position, float radius, const Pierce *pierce, int *pairs) {
+    EcsIter enemies = EcsQuery(world, ENEMY_MASK, 0);
+    while (EcsIterNext(&enemies)) {
+        Position *enemyPosition = EcsColumn(&enemies, COMPONENT_POSITION);
+        Entity *enemyEntities = EcsEntities(&enemies);
+        
+        for (int j = 0; j < enemies.count; j++) {
+            Vector3 enemyCenter = { enemyPosition[j].x, enemyPosition[j].y + 1.0f, enemyPosition[j].z };
+            
+            if (pierce && AlreadyPierced(pierce, enemyEntities[j])) continue;
+            (*pairs)++;
+            if (CheckProjectileCollision(position, radius, enemyCenter, HIT_RADIUS)) {
+                return enemyEntities[j];
+            }
+        }
+    }
+    
+    return ECS_NULL_ENTITY;
+}
+
+// Player shots that stop at the first enemy they hit
+static inline void HitEnemies(EcsWorld *world, EcsIter *it, const ProjectileKind *kind, HitContext *context) {
+    Position *position = EcsColumn(it, COMPONENT_POSITION);
+    Entity *entities = EcsEntities(it);
+    int pairs = 0;
+    int hits = 0;
+    
+    for (int i = 0; i < it->count; i++) {
+        Entity enemy = FindEnemyHit(world, position[i], kind->radius, NULL, &pairs);
+        if (enemy != ECS_NULL_ENTITY) {
+            ResolveEnemies(world, entities[i], kind, enemy, context);
+            hits++;
+        }
+    }
+    
+    TelemetryAdd(METRIC(METRIC_BROADPHASE_PAIRS), pairs);
+    TelemetryAdd(METRIC(METRIC_BROADPHASE_HITS), hits);
+}
+
+// Player shots that pass through a number of enemies before stopping
+static inline void HitPiercing(EcsWorld *world, EcsIter *it, const ProjectileKind *kind, HitContext *context) {
+    Position *position = EcsColumn(it, COMPONENT_POSITION);
+    Pierce *pierce = EcsColumn(it, COMPONENT_PIERCE);
+    Entity *entities = EcsEntities(it);
+    int pairs = 0;
+    int hits = 0;
+    
+    for (int i = 0; i < it->count; i++) {
+        Entity enemy = FindEnemyHit(world, position[i], kind->radius, &pierce[i], &pairs);
+        if (enemy == ECS_NULL_ENTITY) continue;
+        
+        PierceEnemy(world, entities[i], &pierce[i], kind, enemy, context);
+        hits++;
+    }
+    
+    TelemetryAdd(METRIC(METRIC_BROADPHASE_PAIRS), pairs);
+    TelemetryAdd(METRIC(METRIC_BROADPHASE_HITS), hits);
+}
+
+// One hit system per projectile type
+#define X(name, motion, hit, extra) \
+    static void Hit_##name(EcsWorld *world, EcsIter *it, void *context) { \
+        Hit##hit(world, it, &projectileKinds[PROJECTILE_##name], context); \
+    }
+PROJECTILE_KIND_LIST(X)
+#undef X
+
+// Check projectiles against the player and enemies every tick, applying
+// damage. Pools whose archetype has any component in `skip` are left alone.
+void UpdateProjectileHits(EcsWorld *world, HitContext *context, ComponentMask skip) {
+#define X(name, motion, hit, extra) \
+    EcsRunSystem(world, projectileKinds[PROJECTILE_##name].mask, skip, Hit_##name, context);
+    PROJECTILE_KIND_LIST(X)
+#undef X
+}
\ No newline at end of file
@@ -0,0 +1,524 @@
+#include "ecs.h"
+
+// Storage size of every component, tags are zero-sized
+static const size_t componentSizes[COMPONENT_COUNT] = {
+#define X(id, type) [id] = sizeof(type),
+    COMPONENT_LIST(X)
+#undef X
+#define X(id) [id] = 0,
+    TAG_LIST(X)
+#undef X
+#define X(name, motion, hit, extra) [TAG_SHOT_##name] = 0,
+    PROJECTILE_KIND_LIST(X)
+#undef X
+};
+
+// Alignment of command payloads and of each component inside a spawn payload,
+// enough for any component type
+#define ECS_PAYLOAD_ALIGN _Alignof(max_align_t)
+
+static size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static unsigned char *ChunkData(EcsChunk *chunk) {
+    return (unsigned char *)chunk + ECS_CACHE_LINE;
+}
+
+static void *Grow(void *buffer, int *capacity, int needed, size_t elementSize) {
+    if (needed <= *capacity) return buffer;
+
+    int newCapacity = *capacity ? *capacity * 2 : 64;
+    while (newCapacity < needed) newCapacity *= 2;
+
+    void *grown = realloc(buffer, (size_t)newCapacity * elementSize);
+    if (!grown) {
+        TraceLog(LOG_FATAL, "ECS: out of memory growing buffer to %d elements", newCapacity);
+        abort();
+    }
+
+    *capacity = newCapacity;
+    return grown;
+}
+
+//------------------------------------------------------------------------------------
+// Archetypes and chunks
+//------------------------------------------------------------------------------------
+
+// Lay out the columns of a new archetype inside a chunk
+static void InitArchetype(EcsArchetype *archetype, ComponentMask mask) {
+    memset(archetype, 0, sizeof(*archetype));
+    archetype->mask = mask;
+
+    size_t rowSize = sizeof(Entity);
+    int columns = 1;
+    for (int c = 0; c < COMPONENT_COUNT; c++) {
+        archetype->columnOffset[c] = -1;
+        if ((mask & COMPONENT_BIT(c)) && componentSizes[c] > 0) {
+            rowSize += componentSizes[c];
+            columns++;
+        }
+    }
+
+    // Reserve worst-case padding so every column can start on a cache line
+    size_t usable = ECS_CHUNK_SIZE - ECS_CACHE_LINE - (size_t)columns * ECS_CACHE_LINE;
+    archetype->capacity = (int)(usable / rowSize);
+
+    size_t offset = 0;
+    archetype->entityOffset = (int)offset;
+    offset = AlignUp(offset + sizeof(Entity) * archetype->capacity, ECS_CACHE_LINE);
+
+    for (int c = 0; c < COMPONENT_COUNT; c++) {
+        if (!(mask & COMPONENT_BIT(c))) continue;
+
+        // Tags share a harmless zero-length column
+        archetype->columnOffset[c] = (int)offset;
+        offset = AlignUp(offset + componentSizes[c] * archetype->capacity, ECS_CACHE_LINE);
+    }
+}
+
+static int FindOrCreateArchetype(EcsWorld *world, ComponentMask mask) {
+    for (int i = 0; i < world->archetypeCount; i++) {
+        if (world->archetypes[i].mask == mask) return i;
+    }
+
+    if (world->archetypeCount >= ECS_MAX_ARCHETYPES) {
+        TraceLog(LOG_FATAL, "ECS: archetype limit (%d) reached", ECS_MAX_ARCHETYPES);
+        abort();
+    }
+
+    InitArchetype(&world->archetypes[world->archetypeCount], mask);
+    return world->archetypeCount++;
+}
+
+static EcsChunk *NewChunk(EcsArchetype *archetype) {
+    EcsChunk *chunk = archetype->spare;
+    archetype->spare = NULL;
+    if (!chunk) chunk = aligned_alloc(ECS_CACHE_LINE, ECS_CHUNK_SIZE);
+    if (!chunk) {
+        TraceLog(LOG_FATAL, "ECS: out of memory allocating chunk");
+        abort();
+    }
+
+    chunk->archetype = archetype;
+    chunk->count = 0;
+    return chunk;
+}
+
+static void *CellAt(EcsArchetype *archetype, EcsChunk *chunk, ComponentId component, int row) {
+    return ChunkData(chunk) + archetype->columnOffset[component] + componentSizes[component] * row;
+}
+
+static Entity *EntityAt(EcsArchetype *archetype, EcsChunk *chunk, int row) {
+    return (Entity *)(ChunkData(chunk) + archetype->entityOffset) + row;
+}
+
+// Append a zeroed row for an entity, returns its chunk and row through the record
+static void AppendRow(EcsWorld *world, int archetypeIndex, Entity entity) {
+    EcsArchetype *archetype = &world->archetypes[archetypeIndex];
+
+    if (archetype->chunkCount == 0 ||
+        archetype->chunks[archetype->chunkCount - 1]->count == archetype->capacity) {
+        archetype->chunks = Grow(archetype->chunks, &archetype->chunkCapacity,
+                                 archetype->chunkCount + 1, sizeof(EcsChunk *));
+        archetype->chunks[archetype->chunkCount++] = NewChunk(archetype);
+    }
+
+    int chunkIndex = archetype->chunkCount - 1;
+    EcsChunk *chunk = archetype->chunks[chunkIndex];
+    int row = chunk->count++;
+
+    *EntityAt(archetype, chunk, row) = entity;
+    for (int c = 0; c < COMPONENT_COUNT; c++) {
+        if (archetype->columnOffset[c] >= 0 && componentSizes[c] > 0) {
+            memset(CellAt(archetype, chunk, c, row), 0, componentSizes[c]);
+        }
+    }
+
+    archetype->entityCount++;
+
+    EcsRecord *record = &world->records[entity & ECS_INDEX_MASK];
+    record->archetype = archetypeIndex;
+    record->chunk = chunkIndex;
+    record->row = row;
+}
+
+// Remove a row by moving the archetype's last row into the hole
+static void RemoveRow(EcsWorld *world, int archetypeIndex, int chunkIndex, int row) {
+    EcsArchetype *archetype = &world->archetypes[archetypeIndex];
+    EcsChunk *chunk = archetype->chunks[chunkIndex];
+    int lastChunkIndex = archetype->chunkCount - 1;
+    EcsChunk *lastChunk = archetype->chunks[lastChunkIndex];
+    int lastRow = lastChunk->count - 1;
+
+    if (chunk != lastChunk || row != lastRow) {
+        Entity moved = *EntityAt(archetype, lastChunk, lastRow);
+        *EntityAt(archetype, chunk, row) = moved;
+
+        for (int c = 0; c < COMPONENT_COUNT; c++) {
+            if (archetype->columnOffset[c] >= 0 && componentSizes[c] > 0) {
+                memcpy(CellAt(archetype, chunk, c, row), CellAt(archetype, lastChunk, c, lastRow),
+                       componentSizes[c]);
+            }
+        }
+
+        EcsRecord *record = &world->records[moved & ECS_INDEX_MASK];
+        record->chunk = chunkIndex;
+        record->row = row;
+    }
+
+    lastChunk->count--;
+    archetype->entityCount--;
+
+    // Keep one empty chunk around to absorb spawn/destroy churn
+    if (lastChunk->count == 0 && lastChunkIndex > 0) {
+        if (archetype->spare) free(archetype->spare);
+        archetype->spare = lastChunk;
+        archetype->chunkCount--;
+    }
+}
+
+//------------------------------------------------------------------------------------
+// World and entities
+//------------------------------------------------------------------------------------
+
+// Initialize an empty world
+void EcsInitWorld(EcsWorld *world) {
+    memset(world, 0, sizeof(*world));
+}
+
+// Release every chunk and buffer owned by the world
+void EcsFreeWorld(EcsWorld *world) {
+    for (int a = 0; a < world->archetypeCount; a++) {
+        EcsArchetype *archetype = &world->archetypes[a];
+        for (int c = 0; c < archetype->chunkCount; c++) {
+            free(archetype->chunks[c]);
+        }
+        free(archetype->chunks);
+        free(archetype->spare);
+    }
+
+    free(world->records);
+    free(world->freeSlots);
+    free(world->commands);
+    free(world->commandData);
+    memset(world, 0, sizeof(*world));
+}
+
+static EcsRecord *Lookup(EcsWorld *world, Entity entity) {
+    uint32_t index = entity & ECS_INDEX_MASK;
+    if (entity == ECS_NULL_ENTITY || (int)index >= world->recordCount) return NULL;
+
+    EcsRecord *record = &world->records[index];
+    if (record->archetype < 0 || record->generation != entity >> ECS_INDEX_BITS) return NULL;
+
+    return record;
+}
+
+// Create an entity with zero-initialized components. Not allowed while a system runs.
+Entity EcsSpawn(EcsWorld *world, ComponentMask mask) {
+    if (world->iterating) {
+        TraceLog(LOG_WARNING, "ECS: immediate spawn during iteration, use EcsDeferSpawn");
+    }
+
+    int index;
+    if (world->freeCount > 0) {
+        index = world->freeSlots[--world->freeCount];
+    } else {
+        if (world->recordCount > (int)ECS_INDEX_MASK) {
+            TraceLog(LOG_FATAL, "ECS: entity limit reached");
+            abort();
+        }
+        world->records = Grow(world->records, &world->recordCapacity,
+                              world->recordCount + 1, sizeof(EcsRecord));
+        index = world->recordCount++;
+        world->records[index].generation = 0;
+    }
+
+    EcsRecord *record = &world->records[index];
+
+    // Generation zero is skipped so that no live entity equals ECS_NULL_ENTITY
+    record->generation = (record->generation + 1) & (0xFFFFFFFFu >> ECS_INDEX_BITS);
+    if (record->generation == 0) record->generation = 1;
+
+    Entity entity = (record->generation << ECS_INDEX_BITS) | (uint32_t)index;
+    AppendRow(world, FindOrCreateArchetype(world, mask), entity);
+    return entity;
+}
+
+// Destroy an entity. Not allowed while a system runs.
+void EcsDestroy(EcsWorld *world, Entity entity) {
+    EcsRecord *record = Lookup(world, entity);
+    if (!record) return;
+
+    RemoveRow(world, record->archetype, record->chunk, record->row);
+    record->archetype = -1;
+
+    world->freeSlots = Grow(world->freeSlots, &world->freeCapacity, world->freeCount + 1, sizeof(int));
+    world->freeSlots[world->freeCount++] = (int)(entity & ECS_INDEX_MASK);
+}
+
+// Move an entity to the archetype matching a new component mask
+static void MoveEntity(EcsWorld *world, Entity entity, ComponentMask mask) {
+    EcsRecord *record = Lookup(world, entity);
+    EcsArchetype *from = &world->archetypes[record->archetype];
+    if (from->mask == mask) return;
+
+    int fromIndex = record->archetype;
+    int fromChunk = record->chunk;
+    int fromRow = record->row;
+    int toIndex = FindOrCreateArchetype(world, mask);
+
+    AppendRow(world, toIndex, entity);
+
+    EcsArchetype *to = &world->archetypes[toIndex];
+    EcsChunk *src = from->chunks[fromChunk];
+    EcsChunk *dst = to->chunks[record->chunk];
+    for (int c = 0; c < COMPONENT_COUNT; c++) {
+        if (from->columnOffset[c] >= 0 && to->columnOffset[c] >= 0 && componentSizes[c] > 0) {
+            memcpy(CellAt(to, dst, c, record->row), CellAt(from, src, c, fromRow), componentSizes[c]);
+        }
+    }
+
+    RemoveRow(world, fromIndex, fromChunk, fromRow);
+}
+
+void EcsAddComponent(EcsWorld *world, Entity entity, ComponentId component, const void *data) {
+    EcsRecord *record = Lookup(world, entity);
+    if (!record) return;
+
+    MoveEntity(world, entity, world->archetypes[record->archetype].mask | COMPONENT_BIT(component));
+    if (data && componentSizes[component] > 0) {
+        memcpy(EcsGet(world, entity, component), data, componentSizes[component]);
+    }
+}
+
+void EcsRemoveComponent(EcsWorld *world, Entity entity, ComponentId component) {
+    EcsRecord *record = Lookup(world, entity);
+    if (!record) return;
+
+    MoveEntity(world, entity, world->archetypes[record->archetype].mask & ~COMPONENT_BIT(component));
+}
+
+bool EcsIsAlive(EcsWorld *world, Entity entity) {
+    return Lookup(world, entity) != NULL;
+}
+
+bool EcsHas(EcsWorld *world, Entity entity, ComponentId component) {
+    EcsRecord *record = Lookup(world, entity);
+    return record && (world->archetypes[record->archetype].mask & COMPONENT_BIT(component));
+}
+
+// Get a pointer to an entity's component, NULL if dead or missing.
+// The pointer is invalidated by any structural change.
+void *EcsGet(EcsWorld *world, Entity entity, ComponentId component) {
+    EcsRecord *record = Lookup(world, entity);
+    if (!record) return NULL;
+
+    EcsArchetype *archetype = &world->archetypes[record->archetype];
+    if (archetype->columnOffset[component] < 0) return NULL;
+
+    return CellAt(archetype, archetype->chunks[record->chunk], component, record->row);
+}
+
+//------------------------------------------------------------------------------------
+// Deferred structural changes
+//------------------------------------------------------------------------------------
+
+// Size of a spawn payload holding every data component of a mask
+static size_t SpawnPayloadSize(ComponentMask mask) {
+    size_t size = 0;
+    for (int c = 0; c < COMPONENT_COUNT; c++) {
+        if (mask & COMPONENT_BIT(c)) size += AlignUp(componentSizes[c], ECS_PAYLOAD_ALIGN);
+    }
+    return size;
+}
+
+static EcsCommand *PushCommand(EcsWorld *world, EcsCommandType type, Entity entity,
+                               ComponentMask mask, size_t payload) {
+    world->commands = Grow(world->commands, &world->commandCapacity,
+                           world->commandCount + 1, sizeof(EcsCommand));
+
+    // The buffer itself comes from realloc, so aligned offsets give aligned payloads
+    size_t offset = AlignUp(world->commandDataSize, ECS_PAYLOAD_ALIGN);
+    if (offset + payload > world->commandDataCapacity) {
+        size_t capacity = world->commandDataCapacity ? world->commandDataCapacity * 2 : 4096;
+        while (capacity < offset + payload) capacity *= 2;
+
+        unsigned char *grown = realloc(world->commandData, capacity);
+        if (!grown) {
+            TraceLog(LOG_FATAL, "ECS: out of memory growing command buffer");
+            abort();
+        }
+        world->commandData = grown;
+        world->commandDataCapacity = capacity;
+    }
+
+    EcsCommand *command = &world->commands[world->commandCount++];
+    command->type = type;
+    command->entity = entity;
+    command->mask = mask;
+    command->dataOffset = offset;
+
+    if (payload > 0) memset(world->commandData + offset, 0, payload);
+    world->commandDataSize = offset + payload;
+    return command;
+}
+
+// Queue an entity spawn. Returns the zeroed payload to fill in with
+// EcsSpawnComponent; it stays valid until the next deferred command.
+void *EcsDeferSpawn(EcsWorld *world, ComponentMask mask) {
+    EcsCommand *command = PushCommand(world, ECS_CMD_SPAWN, ECS_NULL_ENTITY, mask, SpawnPayloadSize(mask));
+    return world->commandData + command->dataOffset;
+}
+
+// Locate a component inside a spawn payload created with the same mask
+void *EcsSpawnComponent(void *spawn, ComponentMask mask, ComponentId component) {
+    size_t offset = 0;
+    for (int c = 0; c < (int)component; c++) {
+        if (mask & COMPONENT_BIT(c)) offset += AlignUp(componentSizes[c], ECS_PAYLOAD_ALIGN);
+    }
+    return (unsigned char *)spawn + offset;
+}
+
+void EcsDeferDestroy(EcsWorld *world, Entity entity) {
+    PushCommand(world, ECS_CMD_DESTROY, entity, 0, 0);
+}
+
+void EcsDeferAdd(EcsWorld *world, Entity entity, ComponentId component, const void *data) {
+    size_t size = componentSizes[component];
+    if (size > ECS_MAX_COMPONENT_SIZE) {
+        TraceLog(LOG_FATAL, "ECS: component %d too large for a deferred add", component);
+        abort();
+    }
+
+    EcsCommand *command = PushCommand(world, ECS_CMD_ADD, entity, COMPONENT_BIT(component), size);
+    if (data && size > 0) memcpy(world->commandData + command->dataOffset, data, size);
+}
+
+void EcsDeferRemove(EcsWorld *world, Entity entity, ComponentId component) {
+    PushCommand(world, ECS_CMD_REMOVE, entity, COMPONENT_BIT(component), 0);
+}
+
+// Count queued spawns whose mask matches a query, so pool limits can account for them
+int EcsCountDeferredSpawns(EcsWorld *world, ComponentMask all, ComponentMask none) {
+    int count = 0;
+    for (int i = 0; i < world->commandCount; i++) {
+        EcsCommand *command = &world->commands[i];
+        if (command->type == ECS_CMD_SPAWN &&
+            (command->mask & all) == all && !(command->mask & none)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// Apply all queued structural changes in submission order
+void EcsFlush(EcsWorld *world) {
+    if (world->iterating) return;
+
+    for (int i = 0; i < world->commandCount; i++) {
+        EcsCommand *command = &world->commands[i];
+        unsigned char *payload = world->commandData + command->dataOffset;
+
+        switch (command->type) {
+            case ECS_CMD_SPAWN: {
+                Entity entity = EcsSpawn(world, command->mask);
+                for (int c = 0; c < COMPONENT_COUNT; c++) {
+                    if ((command->mask & COMPONENT_BIT(c)) && componentSizes[c] > 0) {
+                        memcpy(EcsGet(world, entity, c),
+                               EcsSpawnComponent(payload, command->mask, c), componentSizes[c]);
+                    }
+                }
+            } break;
+            case ECS_CMD_DESTROY:
+                EcsDestroy(world, command->entity);
+                break;
+            case ECS_CMD_ADD: {
+                ComponentId component = (ComponentId)__builtin_ctz(command->mask);
+                EcsAddComponent(world, command->entity, component,
+                                componentSizes[component] > 0 ? payload : NULL);
+            } break;
+            case ECS_CMD_REMOVE:
+                EcsRemoveComponent(world, command->entity, (ComponentId)__builtin_ctz(command->mask));
+                break;
+        }
+    }
+
+    world->commandCount = 0;
+    world->commandDataSize = 0;
+}
+
+//------------------------------------------------------------------------------------
+// Queries and systems
+//------------------------------------------------------------------------------------
+
+static bool Matches(EcsArchetype *archetype, ComponentMask all, ComponentMask none) {
+    return (archetype->mask & all) == all && !(archetype->mask & none);
+}
+
+// Start iterating the chunks of every archetype matching a query
+EcsIter EcsQuery(EcsWorld *world, ComponentMask all, ComponentMask none) {
+    return (EcsIter){ .world = world, .all = all, .none = none, .archetype = 0, .chunk = -1 };
+}
+
+// Advance to the next non-empty matching chunk
+bool EcsIterNext(EcsIter *it) {
+    EcsWorld *world = it->world;
+
+    while (it->archetype < world->archetypeCount) {
+        EcsArchetype *archetype = &world->archetypes[it->archetype];
+
+        if (Matches(archetype, it->all, it->none)) {
+            while (++it->chunk < archetype->chunkCount) {
+                EcsChunk *chunk = archetype->chunks[it->chunk];
+                if (chunk->count > 0) {
+                    it->current = chunk;
+                    it->count = chunk->count;
+                    return true;
+                }
+            }
+        }
+
+        it->archetype++;
+        it->chunk = -1;
+    }
+
+    it->current = NULL;
+    it->count = 0;
+    return false;
+}
+
+// Column of a component in the current chunk, NULL if the archetype lacks it
+void *EcsColumn(EcsIter *it, ComponentId component) {
+    EcsArchetype *archetype = it->current->archetype;
+    if (archetype->columnOffset[component] < 0) return NULL;
+
+    return ChunkData(it->current) + archetype->columnOffset[component];
+}
+
+Entity *EcsEntities(EcsIter *it) {
+    return EntityAt(it->current->archetype, it->current, 0);
+}
+
+// Run a system once per matching chunk, then apply the changes it deferred
+void EcsRunSystem(EcsWorld *world, ComponentMask all, ComponentMask none, EcsSystem system, void *context) {
+    world->iterating++;
+
+    EcsIter it = EcsQuery(world, all, none);
+    while (EcsIterNext(&it)) {
+        system(world, &it, context);
+    }
+
+    world->iterating--;
+    EcsFlush(world);
+}
+
+// Number of live entities matching a query, without touching any chunk
+int EcsCount(EcsWorld *world, ComponentMask all, ComponentMask none) {
+    int count = 0;
+    for (int a = 0; a < world->archetypeCount; a++) {
+        if (Matches(&world->archetypes[a], all, none)) count += world->archetypes[a].entityCount;
+    }
+    return count;
+}
@@ -1,7 +1,16 @@
 #include "enemy.h"
+#include "metrics.h"
+#include "movement.h"
+#include "worldmap.h"
 
-// Initialize enemies at random positions
-void InitEnemies(Enemy *enemies, int count, Vector3 playerPos) {
+// Per-tick inputs shared by the enemy systems
+typedef struct {
+    Vector3 playerPos;
+    float deltaTime;
+} EnemyContext;
+
+// Spawn enemies at random positions
+void InitEnemies(EcsWorld *world, int count, Vector3 playerPos) {
     for (int i = 0; i < count; i++) {
         // Create random position away from player (at least 5 units away)
         Vector3 pos;
@@ -15,69 +24,138 @@ void InitEnemies(Enemy *enemies, int count, Vector3 playerPos) {
             dist = Vector3Distance(pos, playerPos);
         } while (dist < 5.0f);
         
-        enemies[i].position = pos;
-        enemies[i].size = (Vector3){ 0.8f, 1.8f, 0.8f };
-        enemies[i].velocity = (Vector3){ 0.0f, 0.0f, 0.0f };
-        enemies[i].steeringForce = (Vector3){ 0.0f, 0.0f, 0.0f };
-        enemies[i].health = 100.0f;
-        enemies[i].speed = 0.1f;
-        enemies[i].maxForce = 0.01f;
-        enemies[i].separationRadius = 3.0f;
-        enemies[i].color = BLUE;
-        
-        // Initialize shooting properties
-        enemies[i].shootTimer = 0.0f;
-        enemies[i].shootInterval = GetRandomValue(2, 5); // Random interval between 2-5 seconds
+        SpawnEnemy(world, pos);
+    }
+}
+
+// Create one enemy at a position with fresh health and shooting state
+Entity SpawnEnemy(EcsWorld *world, Vector3 position) {
+    Entity enemy = EcsSpawn(world, ENEMY_MASK);
+    
+    *(Position *)EcsGet(world, enemy, COMPONENT_POSITION) = position;
+    *(Extent *)EcsGet(world, enemy, COMPONENT_EXTENT) = (Vector3){ 0.8f, 1.8f, 0.8f };
+    *(Health *)EcsGet(world, enemy, COMPONENT_HEALTH) = (Health){ 100.0f, 100.0f };
+    *(Renderable *)EcsGet(world, enemy, COMPONENT_RENDERABLE) = (Renderable){ BLUE };
+    *(Steering *)EcsGet(world, enemy, COMPONENT_STEERING) = (Steering){
+        .force = (Vector3){ 0.0f, 0.0f, 0.0f },
+        .maxSpeed = 0.1f,
+        .maxForce = 0.01f,
+        .separationRadius = 3.0f
+    };
+    
+    // Initialize shooting properties
+    *(Shooter *)EcsGet(world, enemy, COMPONENT_SHOOTER) = (Shooter){
+        .timer = 0.0f,
+        .interval = GetRandomValue(2, 5) // Random interval between 2-5 seconds
+    };
+    
+    return enemy;
+}
+
+// Open world respawn point: a random spot around the player, clear of it and
+// inside the world. Near an edge the spot is mirrored to the open side.
+static Vector3 RespawnPosition(Vector3 playerPos) {
+    float angle = GetRandomValue(0, 359) * DEG2RAD;
+    float distance = (float)GetRandomValue((int)RESPAWN_MIN_DISTANCE, (int)RESPAWN_MAX_DISTANCE);
+    Vector3 offset = { cosf(angle) * distance, 0.0f, sinf(angle) * distance };
+    
+    Vector3 position = ClampToWorld(Vector3Add(playerPos, offset));
+    if (Vector3Distance(position, playerPos) < RESPAWN_MIN_DISTANCE) {
+        position = ClampToWorld(Vector3Subtract(playerPos, offset));
     }
+    position.y = 0.0f;
+    return position;
 }
 
 // Draw all enemies
-void DrawEnemies(Enemy *enemies, int count) {
-    for (int i = 0; i < count; i++) {
-        DrawCube(enemies[i].position, enemies[i].size.x, enemies[i].size.y, enemies[i].size.z, enemies[i].color);
-        DrawCubeWires(enemies[i].position, enemies[i].size.x, enemies[i].size.y, enemies[i].size.z, BLACK);
+void DrawEnemies(EcsWorld *world) {
+    EcsIter it = EcsQuery(world, ENEMY_MASK, 0);
+    while (EcsIterNext(&it)) {
+        Position *position = EcsColumn(&it, COMPONENT_POSITION);
+        Velocity *velocity = EcsColumn(&it, COMPONENT_VELOCITY);
+        Extent *size = EcsColumn(&it, COMPONENT_EXTENT);
+        Renderable *render = EcsColumn(&it, COMPONENT_RENDERABLE);
         
-        // Optionally, visualize the velocity vector for debugging
-        Vector3 velocityEnd = Vector3Add(enemies[i].position, 
-                                         Vector3Scale(enemies[i].velocity, 10.0f));
-        DrawLine3D(enemies[i].position, velocityEnd, GREEN);
+        for (int i = 0; i < it.count; i++) {
+            DrawCube(position[i], size[i].x, size[i].y, size[i].z, render[i].color);
+            DrawCubeWires(position[i], size[i].x, size[i].y, size[i].z, BLACK);
+            
+            // Optionally, visualize the velocity vector for debugging
+            Vector3 velocityEnd = Vector3Add(position[i], Vector3Scale(velocity[i], 10.0f));
+            DrawLine3D(position[i], velocityEnd, GREEN);
+        }
+    }
+}
+
+// Damage an enemy, respawning it once its health runs out: anywhere in the
+// arena, or around the player in the open world
+void DamageEnemy(EcsWorld *world, Entity enemy, float damage, Vector3 playerPos, bool openWorld) {
+    Health *health = EcsGet(world, enemy, COMPONENT_HEALTH);
+    Renderable *render = EcsGet(world, enemy, COMPONENT_RENDERABLE);
+    if (!health) return;
+    
+    health->current -= damage;
+    
+    // Change enemy color when hit
+    render->color = PURPLE;
+    
+    // If enemy health drops to 0 or below, "kill" it
+    if (health->current <= 0) {
+        Position *position = EcsGet(world, enemy, COMPONENT_POSITION);
+        if (openWorld) {
+            *position = RespawnPosition(playerPos);
+        } else {
+            // Reset enemy position far away
+            position->x = GetRandomValue(-GRID_SIZE, GRID_SIZE);
+            position->z = GetRandomValue(-GRID_SIZE, GRID_SIZE);
+        }
+        health->current = health->max;
+        render->color = BLUE;
+        TelemetryAdd(METRIC(METRIC_RESPAWNS), 1);
     }
 }
 
 // Calculate seeking force toward a target
-Vector3 SeekForce(Enemy *enemy, Vector3 targetPos) {
+Vector3 SeekForce(Vector3 position, Vector3 velocity, float maxSpeed, Vector3 targetPos) {
     // Direction to target
-    Vector3 desired = Vector3Subtract(targetPos, enemy->position);
+    Vector3 desired = Vector3Subtract(targetPos, position);
     
     if (Vector3Length(desired) > 0.0f) {
         // Scale to maximum speed
-        desired = Vector3Scale(Vector3Normalize(desired), enemy->speed);
+        desired = Vector3Scale(Vector3Normalize(desired), maxSpeed);
         
         // Steering = desired - velocity
-        return Vector3Subtract(desired, enemy->velocity);
+        return Vector3Subtract(desired, velocity);
     }
     
     return (Vector3){ 0.0f, 0.0f, 0.0f };
 }
 
 // Calculate separation force to avoid other enemies
-Vector3 SeparationForce(Enemy *enemy, Enemy *enemies, int count, int ownIndex) {
+Vector3 SeparationForce(EcsWorld *world, Entity self, Vector3 position, Vector3 velocity,
+                        const Steering *steering) {
     Vector3 force = { 0.0f, 0.0f, 0.0f };
     int neighbors = 0;
     
-    for (int i = 0; i < count; i++) {
-        if (i != ownIndex) {
-            float distance = Vector3Distance(enemy->position, enemies[i].position);
+    EcsIter it = EcsQuery(world, COMPONENT_BIT(COMPONENT_POSITION) | COMPONENT_BIT(TAG_ENEMY), 0);
+    while (EcsIterNext(&it)) {
+        Position *other = EcsColumn(&it, COMPONENT_POSITION);
+        Entity *entities = EcsEntities(&it);
+        
+        for (int i = 0; i < it.count; i++) {
+            if (entities[i] == self) continue;
+            
+            float distance = Vector3Distance(position, other[i]);
             
-            if (distance < enemy->separationRadius) {
+            if (distance < steering->separationRadius) {
                 // Vector pointing away from neighbor
-                Vector3 repulsion = Vector3Subtract(enemy->position, enemies[i].position);
+                Vector3 repulsion = Vector3Subtract(position, other[i]);
                 
                 // Weight by distance (closer = stronger)
                 if (Vector3Length(repulsion) > 0) {
                     repulsion = Vector3Normalize(repulsion);
                     // Scale repulsion force inversely by distance
-                    repulsion = Vector3Scale(repulsion, enemy->separationRadius / (distance + 0.01f));
+                    repulsion = Vector3Scale(repulsion, steering->separationRadius / (distance + 0.01f));
                     force = Vector3Add(force, repulsion);
                     neighbors++;
                 }
@@ -91,8 +169,8 @@ Vector3 SeparationForce(Enemy *enemy, Enemy *enemies, int count, int ownIndex) {
         
         // Scale to maximum speed and calculate steering
         if (Vector3Length(force) > 0) {
-            force = Vector3Scale(Vector3Normalize(force), enemy->speed);
-            force = Vector3Subtract(force, enemy->velocity);
+            force = Vector3Scale(Vector3Normalize(force), steering->maxSpeed);
+            force = Vector3Subtract(force, velocity);
         }
     }
     
@@ -100,7 +178,7 @@ Vector3 SeparationForce(Enemy *enemy, Enemy *enemies, int count, int ownIndex) {
 }
 
 // Add a small random force for natural movement
-Vector3 RandomForce(Enemy *enemy) {
+Vector3 RandomForce(void) {
     // Create a small random force occasionally
     if (GetRandomValue(0, 30) == 0) {
         float randomAngle = ((float)GetRandomValue(0, 360)) * DEG2RAD;
@@ -117,11 +195,12 @@ Vector3 RandomForce(Enemy *enemy) {
 }
 
 // Calculate the combined steering force for an enemy
-Vector3 CalculateSteeringForce(Enemy *enemy, Enemy *enemies, int count, int ownIndex, Vector3 playerPos) {
+Vector3 CalculateSteeringForce(EcsWorld *world, Entity self, Vector3 position, Vector3 velocity,
+                               const Steering *steering, Vector3 playerPos) {
     // Calculate individual forces
-    Vector3 seek = SeekForce(enemy, playerPos);
-    Vector3 separation = SeparationForce(enemy, enemies, count, ownIndex);
-    Vector3 random = RandomForce(enemy);
+    Vector3 seek = SeekForce(position, velocity, steering->maxSpeed, playerPos);
+    Vector3 separation = SeparationForce(world, self, position, velocity, steering);
+    Vector3 random = RandomForce();
     
     // Weight and combine forces (adjust weights for different behaviors)
     seek = Vector3Scale(seek, 1.0f);
@@ -133,80 +212,77 @@ Vector3 CalculateSteeringForce(Enemy *enemy, Enemy *enemies, int count, int ownI
     
     // Limit the maximum force
     float magnitude = Vector3Length(totalForce);
-    if (magnitude > enemy->maxForce) {
-        totalForce = Vector3Scale(totalForce, enemy->maxForce / magnitude);
+    if (magnitude > steering->maxForce) {
+        totalForce = Vector3Scale(totalForce, steering->maxForce / magnitude);
     }
     
     return totalForce;
 }
 
-// Update enemy positions using steering behaviors and handle shooting
-void UpdateEnemies(Enemy *enemies, int count, Vector3 playerPos, Projectile *projectiles, int projectileCount, float deltaTime) {
-    for (int i = 0; i < count; i++) {
+// Accumulate steering forces into velocity for one chunk of steered entities
+static void SteeringSystem(EcsWorld *world, EcsIter *it, void *context) {
+    Vector3 playerPos = ((EnemyContext *)context)->playerPos;
+    Position *position = EcsColumn(it, COMPONENT_POSITION);
+    Velocity *velocity = EcsColumn(it, COMPONENT_VELOCITY);
+    Steering *steering = EcsColumn(it, COMPONENT_STEERING);
+    Entity *entities = EcsEntities(it);
+    
+    for (int i = 0; i < it->count; i++) {
         // Calculate steering force
-        Vector3 steeringForce = CalculateSteeringForce(&enemies[i], enemies, count, i, playerPos);
+        steering[i].force = CalculateSteeringForce(world, entities[i], position[i], velocity[i],
+                                                   &steering[i], playerPos);
         
         // Apply force to velocity (acceleration)
-        enemies[i].velocity = Vector3Add(enemies[i].velocity, steeringForce);
+        velocity[i] = Vector3Add(velocity[i], steering[i].force);
         
         // Limit velocity to maximum speed
-        float speed = Vector3Length(enemies[i].velocity);
-        if (speed > enemies[i].speed) {
-            enemies[i].velocity = Vector3Scale(enemies[i].velocity, enemies[i].speed / speed);
+        float speed = Vector3Length(velocity[i]);
+        if (speed > steering[i].maxSpeed) {
+            velocity[i] = Vector3Scale(velocity[i], steering[i].maxSpeed / speed);
         }
-        
-        // Calculate new position
-        Vector3 newPosition = Vector3Add(enemies[i].position, enemies[i].velocity);
-        
-        // Check collision with player
-        BoundingBox enemyBox = GetBoundingBox(newPosition, enemies[i].size);
-        BoundingBox playerBox = GetBoundingBox(playerPos, (Vector3){1.0f, 2.0f, 1.0f});
+    }
+}
 
-        if (CheckCollisionBoxes(enemyBox, playerBox)) {
-            // Don't move if we would collide with player
-            newPosition = GetCorrectedPosition(enemies[i].position, newPosition, enemies[i].size,
-                                            playerPos, (Vector3){1.0f, 2.0f, 1.0f});
-            
-            // Reset velocity to avoid getting stuck
-            enemies[i].velocity = (Vector3){ 0.0f, 0.0f, 0.0f };
-        }
-        
-        // Check collisions with other enemies
-        for (int j = 0; j < count; j++) {
-            if (i != j) { // Don't check collision with self
-                BoundingBox otherEnemyBox = GetBoundingBox(enemies[j].position, enemies[j].size);
-                
-                if (CheckCollisionBoxes(enemyBox, otherEnemyBox)) {
-                    // Don't move if we would collide with another enemy
-                    newPosition = GetCorrectedPosition(enemies[i].position, newPosition, enemies[i].size,
-                                                    enemies[j].position, enemies[j].size);
-                    
-                    // Reset velocity to avoid getting stuck
-                    enemies[i].velocity = (Vector3){ 0.0f, 0.0f, 0.0f };
-                    
-                    // Update enemyBox after position correction
-                    enemyBox = GetBoundingBox(newPosition, enemies[i].size);
-                }
-            }
-        }
-        
-        // Update enemy position with collision-aware position
-        enemies[i].position = newPosition;
-        
+// Fire at the player when the shooting timer allows it
+static void EnemyShootingSystem(EcsWorld *world, EcsIter *it, void *context) {
+    Vector3 playerPos = ((EnemyContext *)context)->playerPos;
+    float deltaTime = ((EnemyContext *)context)->deltaTime;
+    Position *position = EcsColumn(it, COMPONENT_POSITION);
+    Shooter *shooter = EcsColumn(it, COMPONENT_SHOOTER);
+    int fired = 0;
+    int rejected = 0;
+    
+    for (int i = 0; i < it->count; i++) {
         // Handle shooting
-        enemies[i].shootTimer += deltaTime;
+        shooter[i].timer += deltaTime;
         
         // Check if it's time to shoot and if player is in sight (simple distance check)
-        float distanceToPlayer = Vector3Distance(enemies[i].position, playerPos);
-        if (enemies[i].shootTimer >= enemies[i].shootInterval && distanceToPlayer < 15.0f) {
-            // Shoot at player
-            ShootProjectile(projectiles, projectileCount, enemies[i].position, playerPos);
+        float distanceToPlayer = Vector3Distance(position[i], playerPos);
+        if (distanceToPlayer >= MIN_DISTANCE_TO_SHOOT) continue;
+        
+        if (shooter[i].timer >= shooter[i].interval) {
+            // Shoot at player, unless the enemy projectile pool is full
+            if (ShootProjectile(world, position[i], playerPos)) fired++;
+            else rejected++;
             
-            // Reset timer
-            enemies[i].shootTimer = 0.0f;
+            // Reset timer, a refused shot waits for the next interval too
+            shooter[i].timer = 0.0f;
             
             // Set new random interval
-            enemies[i].shootInterval = GetRandomValue(2, 5);
+            shooter[i].interval = GetRandomValue(2, 5);
         }
     }
-} 
\ No newline at end of file
+    
+    // One shared update per chunk rather than per enemy
+    TelemetryAdd(METRIC(METRIC_SHOTS_ENEMY), fired);
+    TelemetryAdd(METRIC(METRIC_REJECTED_ENEMY), rejected);
+}
+
+// Update enemy positions using steering behaviors and handle shooting
+void UpdateEnemies(EcsWorld *world, Vector3 playerPos, Vector3 playerSize, float deltaTime) {
+    EnemyContext context = { playerPos, deltaTime };
+    
+    EcsRunSystem(world, ENEMY_MASK, 0, SteeringSystem, &context);
+    UpdateMovement(world, playerPos, playerSize);
+    EcsRunSystem(world, ENEMY_MASK, 0, EnemyShootingSystem, &context);
+}
\ No newline at end of file
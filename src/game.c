@@ -0,0 +1,100 @@
+#include "game.h"
+#include "metrics.h"
+#include <time.h>
+
+// Initialize the player, the entity store and the starting enemies. Enemies
+// stream in from the world file at worldPath; without one the game falls back
+// to a fixed arena.
+void InitGame(Game *game, const char *worldPath, bool resetWorld, unsigned int seed) {
+    InitCharacter(&game->player);
+    InitMetrics();
+    
+    EcsInitWorld(&game->world);
+    InitCollisionSchedule(&game->schedule);
+    game->scheduledHits = true;
+    
+    game->streaming = worldPath && OpenWorldMap(&game->map, worldPath, resetWorld, seed);
+    if (game->streaming) {
+        // Load the whole starting area at once
+        UpdateWorldStreaming(&game->map, &game->world, game->player.position, MAX_ACTIVE_CHUNKS);
+    } else {
+        InitEnemies(&game->world, MAX_ENEMIES, game->player.position);
+    }
+    
+    game->tick = 0;
+    game->time = 0.0f;
+}
+
+// Advance the simulation by one tick
+void UpdateGame(Game *game, const PlayerInput *input, float deltaTime) {
+    Character *player = &game->player;
+    EcsWorld *world = &game->world;
+    
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    
+    // Update character
+    UpdateCharacter(player, deltaTime);
+    
+    // Apply movement if there is any
+    float moveLength = Vector3Length(input->moveDirection);
+    if (moveLength > 0.0f) {
+        // Normalize using raylib's function, then move sliding around enemies
+        MoveCharacter(player, world, Vector3Normalize(input->moveDirection));
+        if (game->streaming) player->position = ClampToWorld(player->position);
+    }
+    
+    // Handle player shooting
+    if (input->switchWeapon) player->weapon = input->weapon;
+    if (input->shoot) {
+        ShootPlayerProjectile(player, world, input->aimPoint);
+    }
+    
+    // Update enemies with steering behaviors and shooting
+    UpdateEnemies(world, player->position, player->size, deltaTime);
+    
+    // Update projectiles
+    UpdateProjectiles(world, deltaTime);
+    
+    // Check for projectile collisions with player and enemies. Straight shots
+    // are left to the collision schedule unless per-tick testing is forced.
+    HitContext hits = { player, game->streaming };
+    if (game->scheduledHits) {
+        UpdateProjectileHits(world, &hits, COMPONENT_BIT(COMPONENT_FORECAST));
+        UpdateCollisionSchedule(&game->schedule, world, &hits, game->tick, deltaTime);
+    } else {
+        UpdateProjectileHits(world, &hits, 0);
+    }
+    
+    // Park and rehydrate chunks around the player
+    if (game->streaming) {
+        UpdateWorldStreaming(&game->map, world, player->position, STREAM_BUDGET);
+    }
+    
+    // Publish population gauges; counting is per archetype, not per entity
+    int projectiles = 0;
+    for (int type = 0; type < PROJECTILE_TYPE_COUNT; type++) {
+        int live = EcsCount(world, projectileKinds[type].mask, 0);
+        TelemetrySet(METRIC(METRIC_POOL_LIVE + type), live);
+        TelemetryMax(METRIC(METRIC_POOL_HIGH_WATER + type), live);
+        projectiles += live;
+    }
+    TelemetrySet(METRIC(METRIC_PROJECTILES_LIVE), projectiles);
+    TelemetrySet(METRIC(METRIC_ENEMIES_LIVE), EcsCount(world, ENEMY_MASK, 0));
+    
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    TelemetryObserve(METRIC(METRIC_TICK_SECONDS),
+                     (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9);
+    
+    game->tick++;
+    game->time += deltaTime;
+}
+
+// Release everything owned by the simulation
+void FreeGame(Game *game) {
+    // Parks the live enemies so the world file keeps them
+    if (game->streaming) CloseWorldMap(&game->map, &game->world);
+    EcsFreeWorld(&game->world);
+    FreeCollisionSchedule(&game->schedule);
+    FreeMetrics();
+}
\ No newline at end of file
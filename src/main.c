@@ -7,15 +7,25 @@
 ********************************************************************************************/
 
 #include "common.h"
-#include "character.h"
-#include "enemy.h"
-#include "projectile.h"
+#include "game.h"
+#include "metrics.h"
+#include "soak.h"
+#include <time.h>
 
 //------------------------------------------------------------------------------------
 // Program main entry point
 //------------------------------------------------------------------------------------
-int main(void)
+int main(int argc, char **argv)
 {
+    // Headless soak run, no window is opened
+    //--------------------------------------------------------------------------------------
+    SoakConfig soak;
+    switch (ParseSoakArgs(argc, argv, &soak)) {
+        case SOAK_ARGS_NONE: break;
+        case SOAK_ARGS_OK: return RunSoak(&soak);
+        default: return SOAK_EXIT_USAGE;
+    }
+
     // Initialization
     //--------------------------------------------------------------------------------------
     const int screenWidth = 1280;
@@ -25,22 +35,15 @@ int main(void)
     
     // No cursor capture - cursor remains visible and free
 
-    // Initialize character
-    Character player;
-    InitCharacter(&player);
-
-    // Initialize enemies
-    Enemy enemies[MAX_ENEMIES];
-    InitEnemies(enemies, MAX_ENEMIES, player.position);
-
-    // Initialize projectiles
-    Projectile projectiles[MAX_PROJECTILES];
-    InitProjectiles(projectiles, MAX_PROJECTILES);
+    // Initialize character, enemies and projectiles
+    Game game;
+    InitGame(&game, WORLD_FILE, false, (unsigned int)time(NULL));
+    Character *player = &game.player;
 
     // Initialize camera
     Camera3D camera = {
         .position = (Vector3){ 10.0f, 10.0f, 10.0f },    // Camera position
-        .target = player.position,                       // Camera looking at player
+        .target = player->position,                      // Camera looking at player
         .up = (Vector3){ 0.0f, 1.0f, 0.0f },             // Camera up vector (rotation towards target)
         .fovy = 45.0f,                                   // Camera field-of-view Y
         .projection = CAMERA_PERSPECTIVE                 // Perspective projection
@@ -62,9 +65,6 @@ int main(void)
         // Update
         //----------------------------------------------------------------------------------
         
-        // Update character
-        UpdateCharacter(&player, deltaTime);
-        
         // Process keyboard input independently for each direction
         // This ensures multiple keys can be processed simultaneously
         bool upPressed = IsKeyDown(KEY_W) || IsKeyDown(KEY_UP);
@@ -93,98 +93,33 @@ int main(void)
             moveDirection.z -= 1.0f;
         }
         
-        // Apply movement if there is any
-        float moveLength = Vector3Length(moveDirection);
-        if (moveLength > 0.0f) {
-            // Normalize using raylib's function
-            moveDirection = Vector3Normalize(moveDirection);
-            
-            // Calculate new position
-            Vector3 newPosition = player.position;
-            newPosition.x += moveDirection.x * player.speed;
-            newPosition.z += moveDirection.z * player.speed;
-            
-            // Check collision with each enemy
-            for (int i = 0; i < MAX_ENEMIES; i++) {
-                BoundingBox playerBox = GetBoundingBox(newPosition, player.size);
-                BoundingBox enemyBox = GetBoundingBox(enemies[i].position, enemies[i].size);
-                
-                if (CheckCollisionBoxes(playerBox, enemyBox)) {
-                    // Get corrected position that doesn't collide
-                    newPosition = GetCorrectedPosition(player.position, newPosition, player.size, 
-                                                        enemies[i].position, enemies[i].size);
-                }
+        PlayerInput input = { .moveDirection = moveDirection };
+        
+        // Number keys pick the weapon
+        static const ProjectileType weapons[] = {
+            PROJECTILE_PLAYER, PROJECTILE_HOMING, PROJECTILE_SPREAD, PROJECTILE_PIERCING
+        };
+        for (int i = 0; i < (int)(sizeof(weapons) / sizeof(weapons[0])); i++) {
+            if (IsKeyPressed(KEY_ONE + i)) {
+                input.switchWeapon = true;
+                input.weapon = weapons[i];
             }
-            
-            // Update player position with collision-aware position
-            player.position = newPosition;
         }
         
         // Handle player shooting with mouse
         if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-            ShootPlayerProjectile(&player, projectiles, MAX_PROJECTILES, &camera, GetMousePosition());
-        }
-        
-        // Update enemies with steering behaviors and shooting
-        UpdateEnemies(enemies, MAX_ENEMIES, player.position, projectiles, MAX_PROJECTILES, deltaTime);
-        
-        // Update projectiles
-        UpdateProjectiles(projectiles, MAX_PROJECTILES, deltaTime);
-        
-        // Check for projectile collisions with player
-        for (int i = 0; i < MAX_PROJECTILES; i++) {
-            // Only check enemy projectiles
-            if (projectiles[i].active && projectiles[i].type == PROJECTILE_ENEMY) {
-                if (CheckProjectileCollision(projectiles[i], 
-                                            (Vector3){player.position.x, player.position.y + 1.0f, player.position.z}, 
-                                            0.5f)) {
-                    // Player hit by projectile
-                    projectiles[i].active = false;
-                    
-                    // You could implement player health/damage here
-                    // For example: player.health -= 10;
-                }
-            }
+            input.shoot = GetMouseGroundPoint(&camera, GetMousePosition(), &input.aimPoint);
         }
         
-        // Check for player projectile collisions with enemies
-        for (int i = 0; i < MAX_PROJECTILES; i++) {
-            // Only check player projectiles
-            if (projectiles[i].active && projectiles[i].type == PROJECTILE_PLAYER) {
-                for (int j = 0; j < MAX_ENEMIES; j++) {
-                    if (CheckProjectileCollision(projectiles[i], 
-                                                (Vector3){enemies[j].position.x, enemies[j].position.y + 1.0f, enemies[j].position.z}, 
-                                                0.5f)) {
-                        // Enemy hit by projectile
-                        projectiles[i].active = false;
-                        
-                        // Damage enemy
-                        enemies[j].health -= 25.0f;
-                        
-                        // Change enemy color when hit
-                        enemies[j].color = PURPLE;
-                        
-                        // If enemy health drops to 0 or below, "kill" it
-                        if (enemies[j].health <= 0) {
-                            // Reset enemy position far away
-                            enemies[j].position.x = GetRandomValue(-GRID_SIZE, GRID_SIZE);
-                            enemies[j].position.z = GetRandomValue(-GRID_SIZE, GRID_SIZE);
-                            enemies[j].health = 100.0f;
-                            enemies[j].color = BLUE;
-                        }
-                        
-                        break; // Break out of enemy loop after hit
-                    }
-                }
-            }
-        }
+        // Run the simulation
+        UpdateGame(&game, &input, deltaTime);
         
         // Update camera to follow the player with isometric perspective
-        camera.target = player.position;
+        camera.target = player->position;
         camera.position = (Vector3){
-            player.position.x + 10.0f,
-            player.position.y + 10.0f,
-            player.position.z + 10.0f
+            player->position.x + 10.0f,
+            player->position.y + 10.0f,
+            player->position.z + 10.0f
         };
         
         //----------------------------------------------------------------------------------
@@ -200,25 +135,29 @@ int main(void)
                 // Draw grid floor
                 DrawGrid(gridSize, 1.0f);
                 
+                // Outline the simulated chunks
+                if (game.streaming) DrawWorldMap(&game.map);
+                
                 // Draw the player character
-                DrawCharacter(&player);
+                DrawCharacter(player);
                 
                 // Draw enemies
-                DrawEnemies(enemies, MAX_ENEMIES);
+                DrawEnemies(&game.world);
                 
                 // Draw projectiles
-                DrawProjectiles(projectiles, MAX_PROJECTILES);
+                DrawProjectiles(&game.world);
                 
             EndMode3D();
             
             // Draw UI
             DrawText("Use WASD or Arrow Keys to move", 10, 10, 20, BLACK);
-            DrawText("Left-click to shoot at cursor position", 10, 40, 20, BLACK);
+            DrawText("Left-click to shoot at cursor position, 1-4 to switch weapon", 10, 40, 20, BLACK);
             
             // Display debug information
             DrawText(TextFormat("Cursor position: %i, %i", GetMouseX(), GetMouseY()), 10, 70, 20, BLACK);
-            DrawText(TextFormat("Player cooldown: %.2f", player.shootTimer), 10, 100, 20, BLACK);
-            DrawText(TextFormat("Active projectiles: %i", CountActiveProjectiles(projectiles, MAX_PROJECTILES)), 10, 130, 20, BLACK);
+            DrawText(TextFormat("Player cooldown: %.2f", player->shootTimer), 10, 100, 20, BLACK);
+            DrawText(TextFormat("Active projectiles: %i", (int)TelemetryGet(METRIC(METRIC_PROJECTILES_LIVE))), 10, 130, 20, BLACK);
+            DrawText(TextFormat("Weapon: %s", projectileKinds[player->weapon].name), 10, 160, 20, projectileKinds[player->weapon].color);
             
             DrawFPS(screenWidth - 100, 10);
 
@@ -228,6 +167,7 @@ int main(void)
 
     // De-Initialization
     //--------------------------------------------------------------------------------------
+    FreeGame(&game);      // Release entity storage
     CloseWindow();        // Close window and OpenGL context
     //--------------------------------------------------------------------------------------
 
@@ -0,0 +1,69 @@
+#include "metrics.h"
+#include "projectile.h"
+
+// Used when shared memory is unavailable, so updates never need a check
+static _Alignas(TelemetryRegion) unsigned char fallback[sizeof(TelemetryRegion) +
+                                                        METRIC_COUNT * sizeof(TelemetryMetric)];
+
+TelemetryRegion *telemetry = (TelemetryRegion *)fallback;
+
+static char published[64];
+
+// Tick time buckets, from well under budget up to several missed frames
+static const double tickBounds[] = {
+    0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.0167, 0.0333, 0.0667
+};
+
+// Bucket bounds of the histograms in GAME_METRIC_LIST
+static const struct {
+    const double *bounds;
+    int count;
+} histogramBounds[METRIC_COUNT] = {
+    [METRIC_TICK_SECONDS] = { tickBounds, sizeof(tickBounds) / sizeof(tickBounds[0]) }
+};
+
+// Publish the registry for the stats tool and describe every metric
+void InitMetrics(void) {
+    if (published[0]) return;
+    
+    TelemetryRegion *region = TelemetryCreate(METRIC_COUNT, published, sizeof(published));
+    if (region) {
+        telemetry = region;
+        TraceLog(LOG_INFO, "METRICS: publishing %d metrics at /dev/shm%s", METRIC_COUNT, published);
+    } else {
+        published[0] = '\0';
+        telemetry->metricCount = METRIC_COUNT;
+        TraceLog(LOG_WARNING, "METRICS: shared memory unavailable, metrics stay private");
+    }
+    
+#define X(id, kind, name, labels, help) \
+    TelemetryDefine(METRIC(id), kind, name, labels, help, histogramBounds[id].bounds, histogramBounds[id].count);
+    GAME_METRIC_LIST(X)
+#undef X
+    
+    // Each pool metric is one family labelled by projectile type
+    for (int type = 0; type < PROJECTILE_TYPE_COUNT; type++) {
+        char labels[32];
+        snprintf(labels, sizeof(labels), "type=\"%s\"", projectileKinds[type].name);
+        
+        TelemetryDefine(METRIC(METRIC_POOL_LIVE + type), TELEMETRY_GAUGE, "game_pool_live", labels,
+                        "Projectiles live in a type's pool", NULL, 0);
+        TelemetryDefine(METRIC(METRIC_POOL_HIGH_WATER + type), TELEMETRY_GAUGE, "game_pool_high_water", labels,
+                        "Most projectiles ever live at once in a type's pool", NULL, 0);
+        TelemetryDefine(METRIC(METRIC_POOL_FULL + type), TELEMETRY_COUNTER, "game_pool_full_total", labels,
+                        "Projectiles refused because the type's pool was full", NULL, 0);
+    }
+    
+    // Readers only attach once the whole registry is described
+    if (region) TelemetryPublish(region);
+}
+
+// Withdraw the shared registry, keeping the values readable in private memory
+void FreeMetrics(void) {
+    if (!published[0]) return;
+    
+    memcpy(fallback, telemetry, sizeof(fallback));
+    TelemetryUnpublish(telemetry, published);
+    telemetry = (TelemetryRegion *)fallback;
+    published[0] = '\0';
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include "movement.h"
+
+// Correct a move so that it does not overlap any other solid body
+Vector3 ResolveBodyCollisions(EcsWorld *world, Entity self, Vector3 currentPos, Vector3 newPos,
+                              Vector3 size, bool *collided) {
+    BoundingBox box = GetBoundingBox(newPos, size);
+    
+    EcsIter it = EcsQuery(world, COMPONENT_BIT(COMPONENT_POSITION) | COMPONENT_BIT(COMPONENT_EXTENT), 0);
+    while (EcsIterNext(&it)) {
+        Position *position = EcsColumn(&it, COMPONENT_POSITION);
+        Extent *extent = EcsColumn(&it, COMPONENT_EXTENT);
+        Entity *entities = EcsEntities(&it);
+        
+        for (int i = 0; i < it.count; i++) {
+            if (entities[i] == self) continue; // Don't check collision with self
+            
+            if (CheckCollisionBoxes(box, GetBoundingBox(position[i], extent[i]))) {
+                // Don't move if we would collide with another body
+                newPos = GetCorrectedPosition(currentPos, newPos, size, position[i], extent[i]);
+                if (collided) *collided = true;
+                
+                // Update box after position correction
+                box = GetBoundingBox(newPos, size);
+            }
+        }
+    }
+    
+    return newPos;
+}
+
+// Apply velocity to one chunk of bodies, stopping them at obstacles
+static void MovementSystem(EcsWorld *world, EcsIter *it, void *context) {
+    Vector3 *player = context; // Player position and size
+    Position *position = EcsColumn(it, COMPONENT_POSITION);
+    Velocity *velocity = EcsColumn(it, COMPONENT_VELOCITY);
+    Extent *size = EcsColumn(it, COMPONENT_EXTENT);
+    Entity *entities = EcsEntities(it);
+    
+    for (int i = 0; i < it->count; i++) {
+        // Calculate new position
+        Vector3 newPosition = Vector3Add(position[i], velocity[i]);
+        bool collided = false;
+        
+        // Check collision with player
+        BoundingBox bodyBox = GetBoundingBox(newPosition, size[i]);
+        BoundingBox playerBox = GetBoundingBox(player[0], player[1]);
+        
+        if (CheckCollisionBoxes(bodyBox, playerBox)) {
+            // Don't move if we would collide with player
+            newPosition = GetCorrectedPosition(position[i], newPosition, size[i], player[0], player[1]);
+            collided = true;
+        }
+        
+        // Check collisions with other bodies
+        newPosition = ResolveBodyCollisions(world, entities[i], position[i], newPosition, size[i], &collided);
+        
+        // Reset velocity to avoid getting stuck
+        if (collided) velocity[i] = (Vector3){ 0.0f, 0.0f, 0.0f };
+        
+        // Update position with collision-aware position
+        position[i] = newPosition;
+    }
+}
+
+// Move every body by its velocity
+void UpdateMovement(EcsWorld *world, Vector3 playerPos, Vector3 playerSize) {
+    Vector3 player[2] = { playerPos, playerSize };
+    EcsRunSystem(world, BODY_MASK, 0, MovementSystem, player);
+}
\ No newline at end of file
@@ -1,98 +1,175 @@
 #include "projectile.h"
+#include "metrics.h"
 
-// Initialize all projectiles
-void InitProjectiles(Projectile *projectiles, int count) {
-    for (int i = 0; i < count; i++) {
-        projectiles[i].position = (Vector3){0.0f, 0.0f, 0.0f};
-        projectiles[i].direction = (Vector3){0.0f, 0.0f, 0.0f};
-        projectiles[i].speed = 0.3f;
-        projectiles[i].radius = 0.2f;
-        projectiles[i].color = ORANGE;
-        projectiles[i].active = false;
-        projectiles[i].lifetime = 0.0f;
-        projectiles[i].maxLifetime = 3.0f;  // 3 seconds lifetime
-        projectiles[i].type = PROJECTILE_ENEMY; // Default type
+// Spawn a projectile flying along a direction. Spawning is deferred so it is
+// safe from inside systems; returns false when the type's pool is exhausted.
+bool SpawnProjectile(EcsWorld *world, Vector3 position, Vector3 direction, ProjectileType type) {
+    ComponentMask mask = projectileKinds[type].mask;
+    
+    int live = EcsCount(world, mask, 0) + EcsCountDeferredSpawns(world, mask, 0);
+    if (live >= MAX_PROJECTILES) {
+        TelemetryAdd(METRIC(METRIC_POOL_FULL + type), 1);
+        return false;
     }
+    
+    // Type-specific state (homing target, pierce count) starts zeroed
+    void *spawn = EcsDeferSpawn(world, mask);
+    Position *pos = EcsSpawnComponent(spawn, mask, COMPONENT_POSITION);
+    Projectile *projectile = EcsSpawnComponent(spawn, mask, COMPONENT_PROJECTILE);
+    
+    *pos = position;
+    projectile->direction = direction;
+    projectile->lifetime = 0.0f;
+    
+    return true;
 }
 
-// Update projectiles position and check lifetime
-void UpdateProjectiles(Projectile *projectiles, int count, float deltaTime) {
-    for (int i = 0; i < count; i++) {
-        if (projectiles[i].active) {
-            // Update position based on direction and speed
-            projectiles[i].position.x += projectiles[i].direction.x * projectiles[i].speed;
-            projectiles[i].position.y += projectiles[i].direction.y * projectiles[i].speed;
-            projectiles[i].position.z += projectiles[i].direction.z * projectiles[i].speed;
-            
-            // Update lifetime
-            projectiles[i].lifetime += deltaTime;
-            
-            // Deactivate if lifetime exceeds maximum
-            if (projectiles[i].lifetime >= projectiles[i].maxLifetime) {
-                projectiles[i].active = false;
+//------------------------------------------------------------------------------------
+// Flight kernels. Each takes its type's parameters as a constant so the
+// generated per-type kernels carry no per-projectile branching on type.
+//------------------------------------------------------------------------------------
+
+// Age a projectile, destroying it at the end of its life
+static inline void AgeProjectile(EcsWorld *world, Entity entity, Projectile *projectile,
+                                 const ProjectileKind *kind, float deltaTime) {
+    projectile->lifetime += deltaTime;
+    if (projectile->lifetime >= kind->maxLifetime) EcsDeferDestroy(world, entity);
+}
+
+// Fly in a straight line at constant speed
+static inline void FlyStraight(EcsWorld *world, EcsIter *it, const ProjectileKind *kind, float deltaTime) {
+    Position *position = EcsColumn(it, COMPONENT_POSITION);
+    Projectile *projectile = EcsColumn(it, COMPONENT_PROJECTILE);
+    Entity *entities = EcsEntities(it);
+    
+    for (int i = 0; i < it->count; i++) {
+        position[i] = Vector3Add(position[i], Vector3Scale(projectile[i].direction, kind->speed));
+        AgeProjectile(world, entities[i], &projectile[i], kind, deltaTime);
+    }
+}
+
+// Fly straight while slowing down to a stop at the end of life
+static inline void FlyDecaying(EcsWorld *world, EcsIter *it, const ProjectileKind *kind, float deltaTime) {
+    Position *position = EcsColumn(it, COMPONENT_POSITION);
+    Projectile *projectile = EcsColumn(it, COMPONENT_PROJECTILE);
+    Entity *entities = EcsEntities(it);
+    
+    for (int i = 0; i < it->count; i++) {
+        float speed = kind->speed * (1.0f - projectile[i].lifetime / kind->maxLifetime);
+        position[i] = Vector3Add(position[i], Vector3Scale(projectile[i].direction, speed));
+        AgeProjectile(world, entities[i], &projectile[i], kind, deltaTime);
+    }
+}
+
+// Nearest enemy to a position, 0 when there is none
+static Entity NearestEnemy(EcsWorld *world, Vector3 from) {
+    Entity nearest = ECS_NULL_ENTITY;
+    float best = INFINITY;
+    
+    EcsIter it = EcsQuery(world, COMPONENT_BIT(COMPONENT_POSITION) | COMPONENT_BIT(TAG_ENEMY), 0);
+    while (EcsIterNext(&it)) {
+        Position *position = EcsColumn(&it, COMPONENT_POSITION);
+        Entity *entities = EcsEntities(&it);
+        
+        for (int i = 0; i < it.count; i++) {
+            float distance = Vector3DistanceSqr(from, position[i]);
+            if (distance < best) {
+                best = distance;
+                nearest = entities[i];
             }
         }
     }
+    
+    return nearest;
 }
 
-// Draw all active projectiles
-void DrawProjectiles(Projectile *projectiles, int count) {
-    for (int i = 0; i < count; i++) {
-        if (projectiles[i].active) {
-            DrawSphere(projectiles[i].position, projectiles[i].radius, projectiles[i].color);
+// Turn toward a target enemy, acquiring the nearest one when it has none
+static inline void FlyHoming(EcsWorld *world, EcsIter *it, const ProjectileKind *kind, float deltaTime) {
+    Position *position = EcsColumn(it, COMPONENT_POSITION);
+    Projectile *projectile = EcsColumn(it, COMPONENT_PROJECTILE);
+    Homing *homing = EcsColumn(it, COMPONENT_HOMING);
+    Entity *entities = EcsEntities(it);
+    
+    for (int i = 0; i < it->count; i++) {
+        Position *target = EcsGet(world, homing[i].target, COMPONENT_POSITION);
+        if (!target) {
+            homing[i].target = NearestEnemy(world, position[i]);
+            target = EcsGet(world, homing[i].target, COMPONENT_POSITION);
+        }
+        
+        if (target) {
+            // Aim at the target's centre, staying level
+            Vector3 desired = Vector3Subtract(*target, position[i]);
+            desired.y = 0.0f;
+            desired = Vector3Normalize(desired);
+            projectile[i].direction = Vector3Normalize(Vector3Lerp(projectile[i].direction, desired, kind->turnRate));
         }
+        
+        position[i] = Vector3Add(position[i], Vector3Scale(projectile[i].direction, kind->speed));
+        AgeProjectile(world, entities[i], &projectile[i], kind, deltaTime);
     }
 }
 
-// Shoot a projectile from a position toward a target (for enemies)
-void ShootProjectile(Projectile *projectiles, int count, Vector3 position, Vector3 target) {
-    // Find an inactive projectile
-    for (int i = 0; i < count; i++) {
-        if (!projectiles[i].active) {
-            // Set projectile properties
-            projectiles[i].position = position;
-            
-            // Calculate direction vector
-            Vector3 direction = Vector3Subtract(target, position);
-            projectiles[i].direction = Vector3Normalize(direction);
-            
-            // Adjust y position to aim at player's center
-            projectiles[i].position.y = position.y + 1.0f;
-            
-            // Set properties for enemy projectile
-            projectiles[i].color = ORANGE;
-            projectiles[i].speed = 0.3f;
-            projectiles[i].type = PROJECTILE_ENEMY;
-            
-            // Activate projectile
-            projectiles[i].active = true;
-            projectiles[i].lifetime = 0.0f;
+// One flight system per projectile type
+#define X(name, motion, hit, extra) \
+    static void Flight_##name(EcsWorld *world, EcsIter *it, void *context) { \
+        Fly##motion(world, it, &projectileKinds[PROJECTILE_##name], *(float *)context); \
+    }
+PROJECTILE_KIND_LIST(X)
+#undef X
+
+// Update projectiles position and check lifetime, one pool at a time
+void UpdateProjectiles(EcsWorld *world, float deltaTime) {
+#define X(name, motion, hit, extra) \
+    EcsRunSystem(world, projectileKinds[PROJECTILE_##name].mask, 0, Flight_##name, &deltaTime);
+    PROJECTILE_KIND_LIST(X)
+#undef X
+}
+
+// Draw all projectiles
+void DrawProjectiles(EcsWorld *world) {
+    for (int type = 0; type < PROJECTILE_TYPE_COUNT; type++) {
+        const ProjectileKind *kind = &projectileKinds[type];
+        
+        EcsIter it = EcsQuery(world, kind->mask, 0);
+        while (EcsIterNext(&it)) {
+            Position *position = EcsColumn(&it, COMPONENT_POSITION);
             
-            break;  // Only shoot one projectile at a time
+            for (int i = 0; i < it.count; i++) {
+                DrawSphere(position[i], kind->radius, kind->color);
+            }
         }
     }
 }
 
-// Check if a projectile collides with a target
-bool CheckProjectileCollision(Projectile projectile, Vector3 targetPosition, float targetRadius) {
-    if (!projectile.active) return false;
+// Shoot a projectile from a position toward a target (for enemies). Returns
+// false when the pool is full.
+bool ShootProjectile(EcsWorld *world, Vector3 position, Vector3 target) {
+    // Calculate direction vector
+    Vector3 direction = Vector3Normalize(Vector3Subtract(target, position));
+    
+    // Adjust y position to aim at player's center
+    position.y += 1.0f;
     
+    return SpawnProjectile(world, position, direction, PROJECTILE_ENEMY);
+}
+
+// Check if a projectile collides with a target
+bool CheckProjectileCollision(Vector3 projectilePosition, float projectileRadius,
+                              Vector3 targetPosition, float targetRadius) {
     // Calculate distance between projectile and target
-    float distance = Vector3Distance(projectile.position, targetPosition);
+    float distance = Vector3Distance(projectilePosition, targetPosition);
     
     // Check if distance is less than sum of radii
-    return distance < (projectile.radius + targetRadius);
+    return distance < (projectileRadius + targetRadius);
 }
 
-// Count the number of active projectiles
-int CountActiveProjectiles(Projectile *projectiles, int count) {
-    int activeCount = 0;
-    
-    for (int i = 0; i < count; i++) {
-        if (projectiles[i].active) {
-            activeCount++;
-        }
+// Fill level of the fullest projectile pool, 0-1
+float ProjectilePoolOccupancy(EcsWorld *world) {
+    int fullest = 0;
+    for (int type = 0; type < PROJECTILE_TYPE_COUNT; type++) {
+        int live = EcsCount(world, projectileKinds[type].mask, 0);
+        if (live > fullest) fullest = live;
     }
-    
-    return activeCount;
-} 
\ No newline at end of file
+    return (float)fullest / MAX_PROJECTILES;
+}
\ No newline at end of file
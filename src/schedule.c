@@ -0,0 +1,341 @@
+#include "schedule.h"
+#include "metrics.h"
+
+// Side each hit kernel of the kind list aims at
+#define AIMS_AT_PLAYER_Player true
+#define AIMS_AT_PLAYER_Enemies false
+#define AIMS_AT_PLAYER_Piercing false
+
+static const bool aimsAtPlayer[PROJECTILE_TYPE_COUNT] = {
+#define X(name, motion, hit, extra) [PROJECTILE_##name] = AIMS_AT_PLAYER_##hit,
+    PROJECTILE_KIND_LIST(X)
+#undef X
+};
+
+// Types whose hits are predicted rather than tested every tick
+#define SCHEDULED(type) ((projectileKinds[type].mask & COMPONENT_BIT(COMPONENT_FORECAST)) != 0)
+
+// Per-update inputs and tallies shared by the schedule's passes
+typedef struct {
+    CollisionSchedule *schedule;
+    long tick;
+    float deltaTime;
+    int predictions;
+    int publishes;
+} ScheduleContext;
+
+//------------------------------------------------------------------------------------
+// Event queue
+//------------------------------------------------------------------------------------
+
+static void PushEvent(CollisionSchedule *schedule, CollisionEvent event) {
+    if (schedule->count == schedule->capacity) {
+        int capacity = schedule->capacity ? schedule->capacity * 2 : 256;
+        CollisionEvent *events = realloc(schedule->events, (size_t)capacity * sizeof(CollisionEvent));
+        if (!events) {
+            TraceLog(LOG_FATAL, "SCHEDULE: out of memory growing event queue to %d events", capacity);
+            abort();
+        }
+        schedule->events = events;
+        schedule->capacity = capacity;
+    }
+    
+    // Sift up
+    int i = schedule->count++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (schedule->events[parent].tick <= event.tick) break;
+        schedule->events[i] = schedule->events[parent];
+        i = parent;
+    }
+    schedule->events[i] = event;
+}
+
+static CollisionEvent PopEvent(CollisionSchedule *schedule) {
+    CollisionEvent *events = schedule->events;
+    CollisionEvent top = events[0];
+    CollisionEvent last = events[--schedule->count];
+    
+    // Sift the last event down from the root
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= schedule->count) break;
+        if (child + 1 < schedule->count && events[child + 1].tick < events[child].tick) child++;
+        if (last.tick <= events[child].tick) break;
+        events[i] = events[child];
+        i = child;
+    }
+    events[i] = last;
+    
+    return top;
+}
+
+//------------------------------------------------------------------------------------
+// Prediction
+//------------------------------------------------------------------------------------
+
+// Hit sphere centre of a body standing at a position
+static Vector3 HitCenter(Vector3 position) {
+    return (Vector3){ position.x, position.y + 1.0f, position.z };
+}
+
+// Where a Track puts its body on a tick
+static Vector3 TrackAt(const Track *track, long tick) {
+    return Vector3Add(track->origin, Vector3Scale(track->velocity, (float)(tick - track->tick)));
+}
+
+// Whole ticks from now, up to the horizon, during which two points moving
+// apart by `offset + closing * t` are within `reach` of each other. Solves
+// |offset + closing * t| = reach for the entry and exit times around the
+// closest approach.
+static bool ContactWindow(Vector3 offset, Vector3 closing, float reach, int horizon, int *first, int *last) {
+    float a = Vector3DotProduct(closing, closing);
+    float b = Vector3DotProduct(offset, closing);
+    float c = Vector3DotProduct(offset, offset) - reach * reach;
+    float enter, leave;
+    
+    if (a < 1e-9f) {
+        // Moving together: in reach for good or never
+        if (c > 0.0f) return false;
+        enter = 0.0f;
+        leave = (float)horizon;
+    } else {
+        float discriminant = b * b - a * c;
+        if (discriminant < 0.0f) return false;
+        float root = sqrtf(discriminant);
+        enter = (-b - root) / a;
+        leave = (-b + root) / a;
+    }
+    
+    if (leave < 0.0f || enter > (float)horizon) return false;
+    
+    *first = enter > 0.0f ? (int)ceilf(enter) : 0;
+    *last = leave < (float)horizon ? (int)floorf(leave) : horizon;
+    return *first <= *last;
+}
+
+// Queue the window in which a projectile may touch a target, if there is one.
+// The reach is widened by the tolerance a target may stray from its Track, so
+// a real overlap can only happen inside the window.
+static void PredictPair(ScheduleContext *context, Entity projectile, ProjectileType type, const Forecast *forecast,
+                        Vector3 position, Vector3 direction, Entity target, const Track *track) {
+    const ProjectileKind *kind = &projectileKinds[type];
+    Vector3 offset = Vector3Subtract(position, HitCenter(TrackAt(track, context->tick)));
+    Vector3 closing = Vector3Subtract(Vector3Scale(direction, kind->speed), track->velocity);
+    float reach = kind->radius + HIT_RADIUS + CONTACT_TOLERANCE + CONTACT_SLACK;
+    int first, last;
+    
+    context->predictions++;
+    if (!ContactWindow(offset, closing, reach, (int)(forecast->until - context->tick), &first, &last)) return;
+    
+    PushEvent(context->schedule, (CollisionEvent){
+        .tick = context->tick + first,
+        .last = context->tick + last,
+        .projectile = projectile,
+        .target = target,
+        .forecast = forecast->version,
+        .track = track->version,
+        .projectileType = (uint8_t)type,
+        .type = CONTACT_WINDOW
+    });
+}
+
+// Predict a projectile against every target it can hit, superseding its
+// earlier predictions, and queue the end of the new horizon
+static void PredictProjectile(ScheduleContext *context, EcsWorld *world, Entity entity, ProjectileType type,
+                              Vector3 position, const Projectile *projectile, Forecast *forecast) {
+    const ProjectileKind *kind = &projectileKinds[type];
+    
+    // Look no further ahead than the projectile is expected to live
+    int horizon = CONTACT_HORIZON;
+    if (context->deltaTime > 0.0f) {
+        float life = ceilf((kind->maxLifetime - projectile->lifetime) / context->deltaTime);
+        if (life < horizon) horizon = life > 0.0f ? (int)life : 0;
+    }
+    
+    forecast->version++;
+    forecast->until = context->tick + horizon;
+    
+    if (aimsAtPlayer[type]) {
+        PredictPair(context, entity, type, forecast, position, projectile->direction,
+                    ECS_NULL_ENTITY, &context->schedule->player);
+    } else {
+        EcsIter enemies = EcsQuery(world, ENEMY_MASK, 0);
+        while (EcsIterNext(&enemies)) {
+            Track *track = EcsColumn(&enemies, COMPONENT_TRACK);
+            Entity *enemyEntities = EcsEntities(&enemies);
+            
+            for (int j = 0; j < enemies.count; j++) {
+                PredictPair(context, entity, type, forecast, position, projectile->direction,
+                            enemyEntities[j], &track[j]);
+            }
+        }
+    }
+    
+    PushEvent(context->schedule, (CollisionEvent){
+        .tick = forecast->until + 1,
+        .projectile = entity,
+        .forecast = forecast->version,
+        .projectileType = (uint8_t)type,
+        .type = CONTACT_HORIZON_END
+    });
+}
+
+// Predict every projectile aimed at a target's side against its new Track
+static void PredictTarget(ScheduleContext *context, EcsWorld *world, bool player, Entity target,
+                          const Track *track) {
+    for (int type = 0; type < PROJECTILE_TYPE_COUNT; type++) {
+        if (!SCHEDULED(type) || aimsAtPlayer[type] != player) continue;
+        
+        EcsIter it = EcsQuery(world, projectileKinds[type].mask, 0);
+        while (EcsIterNext(&it)) {
+            Position *position = EcsColumn(&it, COMPONENT_POSITION);
+            Projectile *projectile = EcsColumn(&it, COMPONENT_PROJECTILE);
+            Forecast *forecast = EcsColumn(&it, COMPONENT_FORECAST);
+            Entity *entities = EcsEntities(&it);
+            
+            for (int i = 0; i < it.count; i++) {
+                // New projectiles are predicted against everything later on
+                if (forecast[i].version == 0) continue;
+                PredictPair(context, entities[i], type, &forecast[i], position[i], projectile[i].direction,
+                            target, track);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Update passes
+//------------------------------------------------------------------------------------
+
+// Republish the Track of every enemy that strayed from it
+static void TrackSystem(EcsWorld *world, EcsIter *it, void *context) {
+    ScheduleContext *schedule = context;
+    Position *position = EcsColumn(it, COMPONENT_POSITION);
+    Velocity *velocity = EcsColumn(it, COMPONENT_VELOCITY);
+    Track *track = EcsColumn(it, COMPONENT_TRACK);
+    Entity *entities = EcsEntities(it);
+    float tolerance = CONTACT_TOLERANCE * CONTACT_TOLERANCE;
+    
+    for (int i = 0; i < it->count; i++) {
+        if (track[i].version != 0 &&
+            Vector3DistanceSqr(position[i], TrackAt(&track[i], schedule->tick)) <= tolerance) continue;
+        
+        track[i] = (Track){ position[i], velocity[i], schedule->tick, track[i].version + 1 };
+        schedule->publishes++;
+        PredictTarget(schedule, world, false, entities[i], &track[i]);
+    }
+}
+
+// Same for the player, whose velocity is taken from its last step
+static void TrackPlayer(ScheduleContext *context, EcsWorld *world, Character *player) {
+    CollisionSchedule *schedule = context->schedule;
+    Vector3 velocity = schedule->player.version != 0 ?
+        Vector3Subtract(player->position, schedule->playerLast) : (Vector3){ 0.0f, 0.0f, 0.0f };
+    schedule->playerLast = player->position;
+    
+    if (schedule->player.version != 0 &&
+        Vector3Distance(player->position, TrackAt(&schedule->player, context->tick)) <= CONTACT_TOLERANCE) return;
+    
+    schedule->player = (Track){ player->position, velocity, context->tick, schedule->player.version + 1 };
+    context->publishes++;
+    PredictTarget(context, world, true, ECS_NULL_ENTITY, &schedule->player);
+}
+
+// Predict projectiles fired since the last update
+static void PredictNewProjectiles(ScheduleContext *context, EcsWorld *world) {
+    for (int type = 0; type < PROJECTILE_TYPE_COUNT; type++) {
+        if (!SCHEDULED(type)) continue;
+        
+        EcsIter it = EcsQuery(world, projectileKinds[type].mask, 0);
+        while (EcsIterNext(&it)) {
+            Position *position = EcsColumn(&it, COMPONENT_POSITION);
+            Projectile *projectile = EcsColumn(&it, COMPONENT_PROJECTILE);
+            Forecast *forecast = EcsColumn(&it, COMPONENT_FORECAST);
+            Entity *entities = EcsEntities(&it);
+            
+            for (int i = 0; i < it.count; i++) {
+                if (forecast[i].version != 0) continue;
+                PredictProjectile(context, world, entities[i], type, position[i], &projectile[i], &forecast[i]);
+            }
+        }
+    }
+}
+
+void InitCollisionSchedule(CollisionSchedule *schedule) {
+    memset(schedule, 0, sizeof(*schedule));
+}
+
+void FreeCollisionSchedule(CollisionSchedule *schedule) {
+    free(schedule->events);
+    memset(schedule, 0, sizeof(*schedule));
+}
+
+// Resolve the contact events due this tick. Runs after everything has moved.
+void UpdateCollisionSchedule(CollisionSchedule *schedule, EcsWorld *world, const HitContext *hitContext, long tick,
+                             float deltaTime) {
+    Character *player = hitContext->player;
+    ScheduleContext context = { schedule, tick, deltaTime, 0, 0 };
+    int pairs = 0;
+    int hits = 0;
+    
+    // Targets that changed course invalidate only their own predictions
+    TrackPlayer(&context, world, player);
+    EcsRunSystem(world, ENEMY_MASK, 0, TrackSystem, &context);
+    
+    PredictNewProjectiles(&context, world);
+    
+    while (schedule->count > 0 && schedule->events[0].tick <= tick) {
+        CollisionEvent event = PopEvent(schedule);
+        
+        // Drop events of projectiles that are gone or were predicted again
+        if (!EcsIsAlive(world, event.projectile)) continue;
+        Forecast *forecast = EcsGet(world, event.projectile, COMPONENT_FORECAST);
+        if (forecast->version != event.forecast) continue;
+        
+        Position *position = EcsGet(world, event.projectile, COMPONENT_POSITION);
+        Projectile *projectile = EcsGet(world, event.projectile, COMPONENT_PROJECTILE);
+        
+        if (event.type == CONTACT_HORIZON_END) {
+            PredictProjectile(&context, world, event.projectile, event.projectileType, *position,
+                              projectile, forecast);
+            continue;
+        }
+        
+        // ...and of targets that are gone or changed course since
+        Vector3 center;
+        if (event.target == ECS_NULL_ENTITY) {
+            if (schedule->player.version != event.track) continue;
+            center = HitCenter(player->position);
+        } else {
+            if (!EcsIsAlive(world, event.target)) continue;
+            Track *track = EcsGet(world, event.target, COMPONENT_TRACK);
+            if (track->version != event.track) continue;
+            center = HitCenter(*(Position *)EcsGet(world, event.target, COMPONENT_POSITION));
+        }
+        
+        // Inside the window the pair is tested exactly, once per tick
+        pairs++;
+        if (CheckProjectileCollision(*position, projectileKinds[event.projectileType].radius, center, HIT_RADIUS)) {
+            hits++;
+            if (ResolveProjectileHit(world, event.projectile, event.projectileType, event.target, hitContext)) {
+                // Used up: its other events are void
+                forecast->version++;
+                continue;
+            }
+        }
+        
+        event.tick = tick + 1;
+        if (event.tick <= event.last) PushEvent(schedule, event);
+    }
+    
+    // Apply the destruction of projectiles that hit
+    EcsFlush(world);
+    
+    TelemetryAdd(METRIC(METRIC_CONTACT_PREDICTIONS), context.predictions);
+    TelemetryAdd(METRIC(METRIC_TRACK_PUBLISHES), context.publishes);
+    TelemetryAdd(METRIC(METRIC_BROADPHASE_PAIRS), pairs);
+    TelemetryAdd(METRIC(METRIC_BROADPHASE_HITS), hits);
+    TelemetrySet(METRIC(METRIC_CONTACT_EVENTS), schedule->count);
+}
\ No newline at end of file
@@ -0,0 +1,323 @@
+#include "soak.h"
+#include "metrics.h"
+#include <time.h>
+#include <unistd.h>
+
+// Statistics gathered between two time-series rows
+typedef struct {
+    int ticks;
+    double entitySum;
+    double occupancySum;
+    float occupancyPeak;
+    double tickMax;
+} SoakSample;
+
+static void PrintSoakUsage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s --soak SECONDS [options]\n"
+            "  --tick-rate HZ             fixed simulation rate (default 60)\n"
+            "  --sample-interval SECONDS  time-series resolution (default 1)\n"
+            "  --warmup SECONDS           settle time before baselines, less than the run (default 10%% of run, max 30)\n"
+            "  --soak-out PATH            write the time series to PATH\n"
+            "  --world PATH               scratch world file, reset on start (default soak.nwg)\n"
+            "  --seed N                   random seed (default 1)\n"
+            "  --scheduled-hits 0|1       predict straight shots' hits instead of testing every tick (default 1)\n"
+            "  --max-p99-ms MS            fail when rolling p99 tick time exceeds MS\n"
+            "  --max-p999-ms MS           fail when rolling p99.9 tick time exceeds MS\n"
+            "  --max-rss-growth-kb KB     fail when RSS grows more than KB after warmup\n"
+            "  --max-entity-drift N       fail when mean live entities drift more than N\n"
+            "  --max-pool-occupancy F     fail when mean use of the fullest projectile pool exceeds F (0-1)\n",
+            program);
+}
+
+// Parse soak options. Any argument at all selects soak mode.
+SoakArgsResult ParseSoakArgs(int argc, char **argv, SoakConfig *config) {
+    if (argc <= 1) return SOAK_ARGS_NONE;
+
+    *config = (SoakConfig){
+        .duration = -1.0f,
+        .tickRate = 60.0f,
+        .sampleInterval = 1.0f,
+        .warmup = -1.0f,
+        .outputPath = NULL,
+        .worldPath = "soak.nwg",
+        .seed = 1,
+        .scheduledHits = true,
+        .maxP99Ms = -1.0,
+        .maxP999Ms = -1.0,
+        .maxRssGrowthKb = -1.0,
+        .maxEntityDrift = -1.0,
+        .maxPoolOccupancy = -1.0
+    };
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        char *end = NULL;
+        double number = value ? strtod(value, &end) : 0.0;
+        bool numeric = value && end != value && *end == '\0';
+
+        if (strcmp(arg, "--soak-out") == 0 && value) {
+            config->outputPath = value;
+        } else if (strcmp(arg, "--world") == 0 && value) {
+            config->worldPath = value;
+        } else if (!numeric) {
+            PrintSoakUsage(argv[0]);
+            return SOAK_ARGS_ERROR;
+        } else if (strcmp(arg, "--soak") == 0) {
+            config->duration = (float)number;
+        } else if (strcmp(arg, "--tick-rate") == 0) {
+            config->tickRate = (float)number;
+        } else if (strcmp(arg, "--sample-interval") == 0) {
+            config->sampleInterval = (float)number;
+        } else if (strcmp(arg, "--warmup") == 0) {
+            config->warmup = (float)number;
+        } else if (strcmp(arg, "--seed") == 0) {
+            config->seed = (unsigned int)number;
+        } else if (strcmp(arg, "--scheduled-hits") == 0) {
+            config->scheduledHits = number != 0.0;
+        } else if (strcmp(arg, "--max-p99-ms") == 0) {
+            config->maxP99Ms = number;
+        } else if (strcmp(arg, "--max-p999-ms") == 0) {
+            config->maxP999Ms = number;
+        } else if (strcmp(arg, "--max-rss-growth-kb") == 0) {
+            config->maxRssGrowthKb = number;
+        } else if (strcmp(arg, "--max-entity-drift") == 0) {
+            config->maxEntityDrift = number;
+        } else if (strcmp(arg, "--max-pool-occupancy") == 0) {
+            config->maxPoolOccupancy = number;
+        } else {
+            PrintSoakUsage(argv[0]);
+            return SOAK_ARGS_ERROR;
+        }
+        i++; // Skip the option's value
+    }
+
+    if (config->duration <= 0.0f || config->tickRate <= 0.0f || config->sampleInterval <= 0.0f) {
+        PrintSoakUsage(argv[0]);
+        return SOAK_ARGS_ERROR;
+    }
+
+    if (config->warmup < 0.0f) {
+        config->warmup = fminf(config->duration * 0.1f, 30.0f);
+    }
+
+    // A warmup filling the whole run would leave nothing to check
+    if (config->warmup >= config->duration) {
+        PrintSoakUsage(argv[0]);
+        return SOAK_ARGS_ERROR;
+    }
+
+    return SOAK_ARGS_OK;
+}
+
+static double NowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+// Resident set size of this process in kilobytes
+static long ReadRssKb(void) {
+    FILE *file = fopen("/proc/self/statm", "r");
+    if (!file) return -1;
+
+    long pages = 0;
+    long resident = 0;
+    int read = fscanf(file, "%ld %ld", &pages, &resident);
+    fclose(file);
+
+    return read == 2 ? resident * (sysconf(_SC_PAGESIZE) / 1024) : -1;
+}
+
+static int CompareDoubles(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Pick a percentile from an ascending array
+static double Percentile(const double *sorted, int count, double fraction) {
+    int index = (int)ceil(fraction * count) - 1;
+    if (index < 0) index = 0;
+    if (index >= count) index = count - 1;
+    return sorted[index];
+}
+
+// Scripted player: walk a star pattern around a home point and shoot the
+// nearest enemy whenever the trigger is free. In a streamed world the home
+// point circles far from the origin so chunks keep loading and unloading.
+static void BotInput(Game *game, PlayerInput *input) {
+    static const Vector3 directions[] = {
+        { -1.0f, 0.0f, -1.0f }, { 1.0f, 0.0f, 1.0f }, { -1.0f, 0.0f, 1.0f }, { 1.0f, 0.0f, -1.0f },
+        { 0.0f, 0.0f, -1.0f }, { 0.0f, 0.0f, 1.0f }, { -1.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }
+    };
+    Vector3 position = game->player.position;
+    Vector3 home = { 0.0f, 0.0f, 0.0f };
+
+    if (game->streaming) {
+        float angle = game->time * (2.0f * PI / SOAK_ROAM_PERIOD);
+        home = (Vector3){ SOAK_ROAM_RADIUS * (cosf(angle) - 1.0f), 0.0f, SOAK_ROAM_RADIUS * sinf(angle) };
+    }
+
+    *input = (PlayerInput){ 0 };
+
+    // Head home when straying off the grid, otherwise change heading every two seconds
+    Vector3 offset = Vector3Subtract(position, home);
+    if (fabsf(offset.x) > GRID_SIZE / 2 || fabsf(offset.z) > GRID_SIZE / 2) {
+        input->moveDirection = Vector3Scale(offset, -1.0f);
+    } else {
+        int leg = (int)(game->time / 2.0f);
+        input->moveDirection = directions[leg % (int)(sizeof(directions) / sizeof(directions[0]))];
+    }
+    input->moveDirection.y = 0.0f;
+
+    float nearest = INFINITY;
+    EcsIter it = EcsQuery(&game->world, ENEMY_MASK, 0);
+    while (EcsIterNext(&it)) {
+        Position *enemy = EcsColumn(&it, COMPONENT_POSITION);
+        for (int i = 0; i < it.count; i++) {
+            float distance = Vector3Distance(position, enemy[i]);
+            if (distance < nearest) {
+                nearest = distance;
+                input->aimPoint = enemy[i];
+            }
+        }
+    }
+
+    // Pull the trigger a little more often than the cooldown allows,
+    // switching weapons every ten seconds
+    static const ProjectileType weapons[] = {
+        PROJECTILE_PLAYER, PROJECTILE_HOMING, PROJECTILE_SPREAD, PROJECTILE_PIERCING
+    };
+    input->shoot = nearest < INFINITY && game->tick % 6 == 0;
+    input->switchWeapon = true;
+    input->weapon = weapons[(int)(game->time / 10.0f) % (int)(sizeof(weapons) / sizeof(weapons[0]))];
+}
+
+// Run the simulation headless for a fixed duration and check for drift.
+// Returns the process exit code.
+int RunSoak(const SoakConfig *config) {
+    SetTraceLogLevel(LOG_WARNING);
+    SetRandomSeed(config->seed);
+
+    FILE *output = NULL;
+    if (config->outputPath) {
+        output = fopen(config->outputPath, "w");
+        if (!output) {
+            fprintf(stderr, "soak: cannot open %s\n", config->outputPath);
+            return SOAK_EXIT_USAGE;
+        }
+        fprintf(output, "# soak seed=%u tick_rate=%g duration=%g warmup=%g max_projectiles=%d\n",
+                config->seed, config->tickRate, config->duration, config->warmup, MAX_PROJECTILES);
+        fprintf(output, "time_s,tick,p50_ms,p99_ms,p999_ms,max_ms,rss_kb,enemies,projectiles,"
+                        "entities_mean,pool_mean,pool_peak,active_chunks,parked\n");
+    }
+
+    Game game;
+    InitGame(&game, config->worldPath, true, config->seed);
+    game.scheduledHits = config->scheduledHits;
+
+    static double window[SOAK_WINDOW];
+    static double sorted[SOAK_WINDOW];
+    int windowCount = 0;
+
+    float deltaTime = 1.0f / config->tickRate;
+    long totalTicks = (long)(config->duration * config->tickRate);
+    long ticksPerSample = (long)fmaxf(1.0f, config->sampleInterval * config->tickRate);
+    long warmupTicks = (long)(config->warmup * config->tickRate);
+
+    SoakSample sample = { 0 };
+    double warmupEntitySum = 0.0;
+    long baselineRss = -1;
+    double baselineEntities = -1.0;
+    double worstP99 = 0.0, worstP999 = 0.0, worstRssGrowth = 0.0, worstDrift = 0.0, worstPool = 0.0;
+    int violations = 0;
+
+    for (long tick = 0; tick < totalTicks; tick++) {
+        PlayerInput input;
+        BotInput(&game, &input);
+
+        double start = NowMs();
+        UpdateGame(&game, &input, deltaTime);
+        double elapsed = NowMs() - start;
+
+        window[tick % SOAK_WINDOW] = elapsed;
+        if (windowCount < SOAK_WINDOW) windowCount++;
+
+        int projectiles = (int)TelemetryGet(METRIC(METRIC_PROJECTILES_LIVE));
+        int entities = EcsCount(&game.world, 0, 0);
+        float occupancy = ProjectilePoolOccupancy(&game.world);
+
+        sample.ticks++;
+        sample.entitySum += entities;
+        sample.occupancySum += occupancy;
+        sample.occupancyPeak = fmaxf(sample.occupancyPeak, occupancy);
+        sample.tickMax = fmax(sample.tickMax, elapsed);
+        if (tick < warmupTicks) warmupEntitySum += entities;
+
+        // Baselines are taken once the simulation has settled
+        if (tick + 1 == warmupTicks || (warmupTicks == 0 && tick == 0)) {
+            baselineRss = ReadRssKb();
+            baselineEntities = warmupTicks > 0 ? warmupEntitySum / warmupTicks : entities;
+        }
+
+        if ((tick + 1) % ticksPerSample != 0 && tick + 1 != totalTicks) continue;
+
+        // Emit one time-series row
+        memcpy(sorted, window, sizeof(double) * windowCount);
+        qsort(sorted, windowCount, sizeof(double), CompareDoubles);
+
+        double p50 = Percentile(sorted, windowCount, 0.50);
+        double p99 = Percentile(sorted, windowCount, 0.99);
+        double p999 = Percentile(sorted, windowCount, 0.999);
+        long rss = ReadRssKb();
+        int enemies = (int)TelemetryGet(METRIC(METRIC_ENEMIES_LIVE));
+        double entityMean = sample.entitySum / sample.ticks;
+        double poolMean = sample.occupancySum / sample.ticks;
+
+        double now = (double)(tick + 1) / config->tickRate;
+        if (output) {
+            fprintf(output, "%.2f,%ld,%.4f,%.4f,%.4f,%.4f,%ld,%d,%d,%.1f,%.3f,%.3f,%d,%lld\n",
+                    now, game.tick, p50, p99, p999, sample.tickMax, rss, enemies, projectiles,
+                    entityMean, poolMean, sample.occupancyPeak, game.map.activeCount,
+                    game.streaming ? (long long)game.map.header->parkedCount : 0LL);
+        }
+
+        if (tick >= warmupTicks) {
+            double rssGrowth = (baselineRss >= 0 && rss >= 0) ? (double)(rss - baselineRss) : 0.0;
+            double drift = fabs(entityMean - baselineEntities);
+            const char *failed = NULL;
+
+            worstP99 = fmax(worstP99, p99);
+            worstP999 = fmax(worstP999, p999);
+            worstRssGrowth = fmax(worstRssGrowth, rssGrowth);
+            worstDrift = fmax(worstDrift, drift);
+            worstPool = fmax(worstPool, poolMean);
+
+            if (config->maxP99Ms >= 0 && p99 > config->maxP99Ms) failed = "p99 tick time";
+            else if (config->maxP999Ms >= 0 && p999 > config->maxP999Ms) failed = "p99.9 tick time";
+            else if (config->maxRssGrowthKb >= 0 && rssGrowth > config->maxRssGrowthKb) failed = "RSS growth";
+            else if (config->maxEntityDrift >= 0 && drift > config->maxEntityDrift) failed = "entity drift";
+            else if (config->maxPoolOccupancy >= 0 && poolMean > config->maxPoolOccupancy) failed = "pool occupancy";
+
+            if (failed) {
+                violations++;
+                fprintf(stderr, "soak: %s threshold exceeded at t=%.1fs (p99=%.3fms p99.9=%.3fms "
+                                "rss+%.0fkB drift=%.1f pool=%.2f)\n",
+                        failed, now, p99, p999, rssGrowth, drift, poolMean);
+            }
+        }
+
+        sample = (SoakSample){ 0 };
+    }
+
+    FreeGame(&game);
+    if (output) fclose(output);
+
+    printf("soak: %ld ticks, worst p99=%.3fms p99.9=%.3fms, rss growth=%.0fkB, "
+           "entity drift=%.1f, pool occupancy=%.2f, %d violation(s)\n",
+           totalTicks, worstP99, worstP999, worstRssGrowth, worstDrift, worstPool, violations);
+
+    return violations > 0 ? SOAK_EXIT_THRESHOLD : SOAK_EXIT_OK;
+}
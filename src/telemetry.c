@@ -0,0 +1,162 @@
+#include "telemetry.h"
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+static size_t RegionSize(int metricCount) {
+    return sizeof(TelemetryRegion) + (size_t)metricCount * sizeof(TelemetryMetric);
+}
+
+// Create this process's shared segment, returning its name through path.
+// Readers ignore it until TelemetryPublish. Returns NULL when shared memory is
+// unavailable.
+TelemetryRegion *TelemetryCreate(int metricCount, char *path, size_t pathSize) {
+    snprintf(path, pathSize, TELEMETRY_SHM_PREFIX "%d", (int)getpid());
+
+    int fd = shm_open(path, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd < 0) return NULL;
+
+    size_t size = RegionSize(metricCount);
+    if (ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        shm_unlink(path);
+        return NULL;
+    }
+
+    TelemetryRegion *region = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (region == MAP_FAILED) {
+        shm_unlink(path);
+        return NULL;
+    }
+
+    region->version = TELEMETRY_VERSION;
+    region->pid = (int32_t)getpid();
+    region->metricCount = (uint32_t)metricCount;
+    region->startTime = (int64_t)time(NULL);
+    return region;
+}
+
+// Let readers in, once every metric has been defined
+void TelemetryPublish(TelemetryRegion *region) {
+    atomic_store_explicit(&region->magic, TELEMETRY_MAGIC, memory_order_release);
+}
+
+// Remove this process's shared segment
+void TelemetryUnpublish(TelemetryRegion *region, const char *path) {
+    munmap(region, RegionSize((int)region->metricCount));
+    shm_unlink(path);
+}
+
+// Map another process's segment read-only, NULL if it is missing or foreign
+TelemetryRegion *TelemetryAttach(int pid) {
+    char path[64];
+    snprintf(path, sizeof(path), TELEMETRY_SHM_PREFIX "%d", pid);
+
+    int fd = shm_open(path, O_RDONLY, 0);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TelemetryRegion)) {
+        close(fd);
+        return NULL;
+    }
+
+    TelemetryRegion *region = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (region == MAP_FAILED) return NULL;
+
+    // Pairs with the release in TelemetryPublish, so the definitions are visible
+    if (atomic_load_explicit(&region->magic, memory_order_acquire) != TELEMETRY_MAGIC ||
+        region->version != TELEMETRY_VERSION ||
+        RegionSize((int)region->metricCount) > (size_t)st.st_size) {
+        munmap(region, (size_t)st.st_size);
+        return NULL;
+    }
+
+    return region;
+}
+
+void TelemetryDetach(TelemetryRegion *region) {
+    munmap(region, RegionSize((int)region->metricCount));
+}
+
+// Describe a metric slot. Bounds are only used by histograms.
+void TelemetryDefine(TelemetryMetric *metric, TelemetryKind kind, const char *name, const char *labels,
+                     const char *help, const double *bounds, int bucketCount) {
+    memset(metric, 0, sizeof(*metric));
+    snprintf(metric->name, sizeof(metric->name), "%s", name);
+    snprintf(metric->labels, sizeof(metric->labels), "%s", labels);
+    snprintf(metric->help, sizeof(metric->help), "%s", help);
+    metric->kind = kind;
+
+    if (bucketCount > TELEMETRY_MAX_BUCKETS) bucketCount = TELEMETRY_MAX_BUCKETS;
+    metric->bucketCount = (uint32_t)bucketCount;
+    for (int i = 0; i < bucketCount; i++) metric->bounds[i] = bounds[i];
+}
+
+// Record one histogram observation
+void TelemetryObserve(TelemetryMetric *metric, double value) {
+    uint32_t bucket = 0;
+    while (bucket < metric->bucketCount && value > metric->bounds[bucket]) bucket++;
+
+    atomic_fetch_add_explicit(&metric->buckets[bucket], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&metric->sum, (int64_t)(value * TELEMETRY_SUM_SCALE), memory_order_relaxed);
+    atomic_fetch_add_explicit(&metric->value, 1, memory_order_relaxed);
+}
+
+static int64_t Load(const _Atomic int64_t *value) {
+    return atomic_load_explicit((_Atomic int64_t *)value, memory_order_relaxed);
+}
+
+// Print a sample line, merging extra labels into the metric's own
+static void WriteSample(FILE *out, const char *name, const char *suffix, const char *labels,
+                        const char *extra, const char *value) {
+    bool any = labels[0] || extra[0];
+    fprintf(out, "%s%s%s%s%s%s%s %s\n", name, suffix, any ? "{" : "", labels,
+            labels[0] && extra[0] ? "," : "", extra, any ? "}" : "", value);
+}
+
+// Render the registry in the Prometheus text exposition format. Metrics
+// sharing a name must be defined next to each other.
+void TelemetryWritePrometheus(const TelemetryRegion *region, FILE *out) {
+    static const char *types[] = { "counter", "gauge", "histogram" };
+    const char *previous = "";
+    char value[64];
+    char le[48];
+
+    for (uint32_t m = 0; m < region->metricCount; m++) {
+        const TelemetryMetric *metric = &region->metrics[m];
+        if (metric->kind > TELEMETRY_HISTOGRAM) continue;
+
+        if (strcmp(metric->name, previous) != 0) {
+            fprintf(out, "# HELP %s %s\n", metric->name, metric->help);
+            fprintf(out, "# TYPE %s %s\n", metric->name, types[metric->kind]);
+            previous = metric->name;
+        }
+
+        if (metric->kind != TELEMETRY_HISTOGRAM) {
+            snprintf(value, sizeof(value), "%lld", (long long)Load(&metric->value));
+            WriteSample(out, metric->name, "", metric->labels, "", value);
+            continue;
+        }
+
+        // Buckets are stored individually and exposed cumulatively
+        int64_t cumulative = 0;
+        for (uint32_t b = 0; b <= metric->bucketCount; b++) {
+            cumulative += Load(&metric->buckets[b]);
+            if (b < metric->bucketCount) snprintf(le, sizeof(le), "le=\"%g\"", metric->bounds[b]);
+            else snprintf(le, sizeof(le), "le=\"+Inf\"");
+            snprintf(value, sizeof(value), "%lld", (long long)cumulative);
+            WriteSample(out, metric->name, "_bucket", metric->labels, le, value);
+        }
+
+        snprintf(value, sizeof(value), "%.6f", Load(&metric->sum) / TELEMETRY_SUM_SCALE);
+        WriteSample(out, metric->name, "_sum", metric->labels, "", value);
+        snprintf(value, sizeof(value), "%lld", (long long)Load(&metric->value));
+        WriteSample(out, metric->name, "_count", metric->labels, "", value);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,473 @@
+#include "worldmap.h"
+#include "enemy.h"
+#include "metrics.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define WORLD_HEADER_SIZE 4096  // Header page, keeps the tiles page-aligned
+
+_Static_assert(sizeof(ChunkSlot) == CHUNK_SLOT_SIZE, "chunk slot must match its on-disk size");
+_Static_assert(sizeof(WorldFileHeader) <= WORLD_HEADER_SIZE, "world header must fit its page");
+_Static_assert(WORLD_CHUNKS % TILE_CHUNKS == 0, "world must be made of whole tiles");
+
+static const char worldMagic[8] = { 'N', 'W', 'G', 'W', 'O', 'R', 'L', 'D' };
+
+// Live places of an active chunk, or of the chunks around the player, handed
+// to the enemies nearest the player
+typedef struct {
+    int capacity;
+    int seen;                      // Enemies standing in it
+    int ties;                      // Enemies kept live so far at the cutoff distance
+    float *nearest;                // Squared player distances of its nearest enemies, ascending
+} LiveCap;
+
+// Context of the parking pass
+typedef struct {
+    WorldMap *map;
+    Vector3 playerPos;
+    int parked;
+    int dropped;
+    LiveCap chunks[MAX_ACTIVE_CHUNKS];
+    LiveCap around;                // Player's chunk and its neighbours, sharing their places
+    float chunkNearest[MAX_ACTIVE_CHUNKS][MAX_LIVE_PER_CHUNK];
+    float aroundNearest[MAX_LIVE_AROUND_PLAYER];
+} ParkContext;
+
+//------------------------------------------------------------------------------------
+// Chunk addressing
+//------------------------------------------------------------------------------------
+
+// Chunk containing a world position, clamped to the world
+ChunkCoord ChunkAt(Vector3 position) {
+    ChunkCoord coord = {
+        (int)floorf((position.x + WORLD_HALF_EXTENT) / CHUNK_SIZE),
+        (int)floorf((position.z + WORLD_HALF_EXTENT) / CHUNK_SIZE)
+    };
+    if (coord.x < 0) coord.x = 0;
+    if (coord.z < 0) coord.z = 0;
+    if (coord.x >= WORLD_CHUNKS) coord.x = WORLD_CHUNKS - 1;
+    if (coord.z >= WORLD_CHUNKS) coord.z = WORLD_CHUNKS - 1;
+    return coord;
+}
+
+// Keep a position inside the world
+Vector3 ClampToWorld(Vector3 position) {
+    float limit = WORLD_HALF_EXTENT - 0.5f;
+    position.x = fminf(fmaxf(position.x, -limit), limit);
+    position.z = fminf(fmaxf(position.z, -limit), limit);
+    return position;
+}
+
+static Vector3 ChunkOrigin(ChunkCoord coord) {
+    return (Vector3){ coord.x * CHUNK_SIZE - WORLD_HALF_EXTENT, 0.0f, coord.z * CHUNK_SIZE - WORLD_HALF_EXTENT };
+}
+
+static bool InWorld(ChunkCoord coord) {
+    return coord.x >= 0 && coord.z >= 0 && coord.x < WORLD_CHUNKS && coord.z < WORLD_CHUNKS;
+}
+
+static int ChunkDistance(ChunkCoord a, ChunkCoord b) {
+    int dx = abs(a.x - b.x);
+    int dz = abs(a.z - b.z);
+    return dx > dz ? dx : dz;
+}
+
+// Byte offset of a tile; slots are stored tile by tile so nearby chunks share a page
+static size_t TileOffset(ChunkCoord coord) {
+    size_t tile = (size_t)(coord.z / TILE_CHUNKS) * (WORLD_CHUNKS / TILE_CHUNKS) + coord.x / TILE_CHUNKS;
+    return WORLD_HEADER_SIZE + tile * TILE_SIZE;
+}
+
+static ChunkSlot *SlotAt(WorldMap *map, ChunkCoord coord) {
+    size_t local = (size_t)(coord.z % TILE_CHUNKS) * TILE_CHUNKS + coord.x % TILE_CHUNKS;
+    return (ChunkSlot *)(map->base + TileOffset(coord) + local * CHUNK_SLOT_SIZE);
+}
+
+static void AdviseTile(WorldMap *map, ChunkCoord coord, int advice) {
+    if (sysconf(_SC_PAGESIZE) > TILE_SIZE) return;
+    madvise(map->base + TileOffset(coord), TILE_SIZE, advice);
+}
+
+static int FindActive(WorldMap *map, ChunkCoord coord) {
+    for (int i = 0; i < map->activeCount; i++) {
+        if (map->active[i].x == coord.x && map->active[i].z == coord.z) return i;
+    }
+    return -1;
+}
+
+//------------------------------------------------------------------------------------
+// Chunk contents
+//------------------------------------------------------------------------------------
+
+static uint64_t SplitMix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Fill a never-visited chunk. Contents depend only on the seed and the coordinate.
+static void GenerateChunk(WorldMap *map, ChunkCoord coord, ChunkSlot *slot) {
+    uint64_t state = map->header->seed ^ ((uint64_t)coord.x << 32) ^ (uint64_t)coord.z;
+    int count = (int)(SplitMix64(&state) % (MAX_GENERATED_ENEMIES + 1));
+    Vector3 origin = ChunkOrigin(coord);
+
+    slot->count = 0;
+    for (int i = 0; i < count; i++) {
+        uint64_t bits = SplitMix64(&state);
+        ParkedEnemy enemy = {
+            .x = (uint16_t)bits,
+            .z = (uint16_t)(bits >> 16),
+            .health = 255,
+            .shootTimer = 0,
+            .shootInterval = (uint8_t)(2 + (bits >> 32) % 4), // Random interval between 2-5 seconds
+            .flags = 0
+        };
+
+        // Keep the player's starting area clear (at least 5 units away)
+        Vector3 pos = {
+            origin.x + enemy.x * (CHUNK_SIZE / 65536.0f), 0.0f, origin.z + enemy.z * (CHUNK_SIZE / 65536.0f)
+        };
+        if (Vector3Length(pos) < 5.0f) continue;
+
+        slot->enemies[slot->count++] = enemy;
+    }
+
+    slot->flags |= CHUNK_GENERATED;
+    map->header->parkedCount += slot->count;
+}
+
+// Compress an enemy into its chunk's slot, false if the slot is full
+static bool ParkEnemy(WorldMap *map, EcsWorld *world, Entity entity) {
+    Position *position = EcsGet(world, entity, COMPONENT_POSITION);
+    ChunkCoord coord = ChunkAt(*position);
+    ChunkSlot *slot = SlotAt(map, coord);
+
+    if (!(slot->flags & CHUNK_GENERATED)) GenerateChunk(map, coord, slot);
+    if (slot->count >= MAX_PARKED_PER_CHUNK) return false;
+
+    Health *health = EcsGet(world, entity, COMPONENT_HEALTH);
+    Shooter *shooter = EcsGet(world, entity, COMPONENT_SHOOTER);
+    Renderable *render = EcsGet(world, entity, COMPONENT_RENDERABLE);
+    Vector3 local = Vector3Subtract(ClampToWorld(*position), ChunkOrigin(coord));
+
+    slot->enemies[slot->count++] = (ParkedEnemy){
+        .x = (uint16_t)Clamp(local.x / CHUNK_SIZE * 65536.0f, 0.0f, 65535.0f),
+        .z = (uint16_t)Clamp(local.z / CHUNK_SIZE * 65536.0f, 0.0f, 65535.0f),
+        .health = (uint8_t)Clamp(health->current / health->max * 255.0f, 1.0f, 255.0f),
+        .shootTimer = (uint8_t)Clamp(shooter->timer * 10.0f, 0.0f, 255.0f),
+        .shootInterval = (uint8_t)Clamp(shooter->interval, 0.0f, 255.0f),
+        .flags = (render->color.r == PURPLE.r && render->color.b == PURPLE.b) ? PARKED_HIT : 0
+    };
+    map->header->parkedCount++;
+    return true;
+}
+
+// Bring a chunk's parked enemies back into the entity store, up to the live
+// cap; the rest stay parked until the chunk is loaded again
+static void UnparkChunk(WorldMap *map, EcsWorld *world, ChunkCoord coord) {
+    ChunkSlot *slot = SlotAt(map, coord);
+    if (!(slot->flags & CHUNK_GENERATED)) GenerateChunk(map, coord, slot);
+
+    int count = slot->count < MAX_LIVE_PER_CHUNK ? slot->count : MAX_LIVE_PER_CHUNK;
+    Vector3 origin = ChunkOrigin(coord);
+    for (int i = slot->count - count; i < slot->count; i++) {
+        ParkedEnemy *parked = &slot->enemies[i];
+        Vector3 position = {
+            origin.x + parked->x * (CHUNK_SIZE / 65536.0f), 0.0f, origin.z + parked->z * (CHUNK_SIZE / 65536.0f)
+        };
+        Entity entity = SpawnEnemy(world, position);
+
+        Health *health = EcsGet(world, entity, COMPONENT_HEALTH);
+        health->current = health->max * parked->health / 255.0f;
+
+        Shooter *shooter = EcsGet(world, entity, COMPONENT_SHOOTER);
+        shooter->timer = parked->shootTimer / 10.0f;
+        shooter->interval = parked->shootInterval;
+
+        if (parked->flags & PARKED_HIT) {
+            ((Renderable *)EcsGet(world, entity, COMPONENT_RENDERABLE))->color = PURPLE;
+        }
+    }
+
+    map->header->parkedCount -= count;
+    slot->count -= count;
+}
+
+static void InitParkContext(ParkContext *park, WorldMap *map, Vector3 playerPos) {
+    memset(park, 0, sizeof(*park));
+    park->map = map;
+    park->playerPos = playerPos;
+    for (int i = 0; i < MAX_ACTIVE_CHUNKS; i++) {
+        park->chunks[i] = (LiveCap){ .capacity = MAX_LIVE_PER_CHUNK, .nearest = park->chunkNearest[i] };
+    }
+    park->around = (LiveCap){ .capacity = MAX_LIVE_AROUND_PLAYER, .nearest = park->aroundNearest };
+}
+
+// Places an enemy in an active chunk competes for. Around the player they are
+// pooled, so a crowd on one side of a chunk border is not cut down in sight.
+static LiveCap *CapOf(ParkContext *park, int active) {
+    if (ChunkDistance(park->map->active[active], park->map->center) <= 1) return &park->around;
+    return &park->chunks[active];
+}
+
+// Rank one chunk of enemies by distance to the player, remembering the
+// nearest that fit each cap
+static void RankSystem(EcsWorld *world, EcsIter *it, void *context) {
+    ParkContext *park = context;
+    Position *position = EcsColumn(it, COMPONENT_POSITION);
+
+    for (int i = 0; i < it->count; i++) {
+        int active = FindActive(park->map, ChunkAt(position[i]));
+        if (active < 0) continue;
+
+        LiveCap *cap = CapOf(park, active);
+        int kept = cap->seen < cap->capacity ? cap->seen : cap->capacity;
+        float distance = Vector3DistanceSqr(position[i], park->playerPos);
+        cap->seen++;
+
+        // Insertion into the sorted list, dropping its farthest when full
+        if (kept == cap->capacity && distance >= cap->nearest[kept - 1]) continue;
+        int j = kept < cap->capacity ? kept : cap->capacity - 1;
+        for (; j > 0 && cap->nearest[j - 1] > distance; j--) cap->nearest[j] = cap->nearest[j - 1];
+        cap->nearest[j] = distance;
+    }
+}
+
+// Whether an enemy in an active chunk is among the nearest to the player its
+// cap has room for
+static bool KeepLive(LiveCap *cap, float distance) {
+    if (cap->seen <= cap->capacity) return true;
+
+    float cutoff = cap->nearest[cap->capacity - 1];
+    if (distance < cutoff) return true;
+    if (distance > cutoff) return false;
+
+    // Enemies exactly at the cutoff share the places left by nearer ones
+    int below = 0;
+    while (below < cap->capacity && cap->nearest[below] < cutoff) below++;
+    return ++cap->ties <= cap->capacity - below;
+}
+
+// Park one chunk of enemies that stand outside the active area, or crowd past
+// a live cap, farthest from the player first. Followers of the player pile up
+// in the chunks around it, so without the caps the live population would grow
+// with the distance travelled rather than stay bound to the active area.
+// RankSystem must have run over every enemy first.
+static void ParkSystem(EcsWorld *world, EcsIter *it, void *context) {
+    ParkContext *park = context;
+    Position *position = EcsColumn(it, COMPONENT_POSITION);
+    Entity *entities = EcsEntities(it);
+
+    for (int i = 0; i < it->count; i++) {
+        int active = FindActive(park->map, ChunkAt(position[i]));
+        if (active >= 0 && KeepLive(CapOf(park, active), Vector3DistanceSqr(position[i], park->playerPos))) continue;
+
+        // An enemy that does not fit its chunk's slot is dropped from the world
+        if (ParkEnemy(park->map, world, entities[i])) {
+            park->parked++;
+        } else {
+            park->dropped++;
+        }
+        EcsDeferDestroy(world, entities[i]);
+    }
+}
+
+//------------------------------------------------------------------------------------
+// World file
+//------------------------------------------------------------------------------------
+
+// Map the world file, creating or resetting it when needed. The file is sparse:
+// untouched chunks cost neither disk blocks nor memory.
+bool OpenWorldMap(WorldMap *map, const char *path, bool reset, unsigned int seed) {
+    memset(map, 0, sizeof(*map));
+    map->fd = -1;
+
+    size_t tiles = (size_t)(WORLD_CHUNKS / TILE_CHUNKS) * (WORLD_CHUNKS / TILE_CHUNKS);
+    size_t size = WORLD_HEADER_SIZE + tiles * TILE_SIZE;
+
+    // Truncated only once locked, so a reset never wipes a file another game has mapped
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        TraceLog(LOG_WARNING, "WORLD: cannot open %s, streaming disabled", path);
+        return false;
+    }
+
+    // Games sharing a world file would overwrite each other's slots; the lock
+    // lasts until the file is closed
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        TraceLog(LOG_WARNING, "WORLD: cannot lock %s (%s), streaming disabled", path, strerror(errno));
+        close(fd);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        TraceLog(LOG_WARNING, "WORLD: cannot stat %s (%s), streaming disabled", path, strerror(errno));
+        close(fd);
+        return false;
+    }
+
+    // Reuse the file only when its layout matches this build
+    WorldFileHeader existing = { 0 };
+    bool valid = !reset && (size_t)st.st_size == size &&
+                 pread(fd, &existing, sizeof(existing), 0) == (ssize_t)sizeof(existing) &&
+                 memcmp(existing.magic, worldMagic, sizeof(worldMagic)) == 0 &&
+                 existing.version == WORLD_FILE_VERSION && existing.chunksPerSide == WORLD_CHUNKS &&
+                 existing.chunkCells == CHUNK_CELLS && existing.slotSize == CHUNK_SLOT_SIZE;
+
+    if (!valid) {
+        if (!reset && st.st_size > 0) TraceLog(LOG_WARNING, "WORLD: %s has an incompatible layout, regenerating", path);
+
+        if (ftruncate(fd, 0) != 0 || ftruncate(fd, (off_t)size) != 0) {
+            TraceLog(LOG_WARNING, "WORLD: cannot size %s, streaming disabled", path);
+            close(fd);
+            return false;
+        }
+    }
+
+    unsigned char *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        TraceLog(LOG_WARNING, "WORLD: cannot map %s, streaming disabled", path);
+        close(fd);
+        return false;
+    }
+
+    WorldFileHeader *header = (WorldFileHeader *)base;
+    if (!valid) {
+        memcpy(header->magic, worldMagic, sizeof(worldMagic));
+        header->version = WORLD_FILE_VERSION;
+        header->chunksPerSide = WORLD_CHUNKS;
+        header->chunkCells = CHUNK_CELLS;
+        header->slotSize = CHUNK_SLOT_SIZE;
+        header->seed = seed;
+        header->parkedCount = 0;
+    }
+
+    map->fd = fd;
+    map->base = base;
+    map->size = size;
+    map->header = header;
+    map->center = (ChunkCoord){ -1, -1 };
+
+    TraceLog(LOG_INFO, "WORLD: mapped %s (%d x %d chunks, %lld parked enemies)",
+             path, WORLD_CHUNKS, WORLD_CHUNKS, (long long)header->parkedCount);
+    return true;
+}
+
+// Park every live enemy and unmap the world file
+void CloseWorldMap(WorldMap *map, EcsWorld *world) {
+    if (!map->base) return;
+
+    // With nothing active, the parking pass sends every enemy home
+    map->activeCount = 0;
+    ParkContext park;
+    InitParkContext(&park, map, Vector3Zero());
+    EcsRunSystem(world, ENEMY_MASK, 0, ParkSystem, &park);
+    TelemetryAdd(METRIC(METRIC_ENEMIES_DROPPED), park.dropped);
+    TelemetrySet(METRIC(METRIC_PARKED_ENEMIES), map->header->parkedCount);
+
+    msync(map->base, map->size, MS_SYNC);
+    munmap(map->base, map->size);
+    close(map->fd);
+    memset(map, 0, sizeof(*map));
+    map->fd = -1;
+}
+
+//------------------------------------------------------------------------------------
+// Streaming
+//------------------------------------------------------------------------------------
+
+// Move the active area with the player, doing at most `budget` chunk loads and
+// unloads so that crossing a chunk border never stalls a frame
+void UpdateWorldStreaming(WorldMap *map, EcsWorld *world, Vector3 playerPos, int budget) {
+    if (!map->base) return;
+
+    ChunkCoord center = ChunkAt(playerPos);
+    bool moved = center.x != map->center.x || center.z != map->center.z;
+    map->center = center;
+
+    // Unload chunks that fell behind; one chunk of hysteresis avoids thrashing on borders
+    ChunkCoord released[MAX_ACTIVE_CHUNKS];
+    int releasedCount = 0;
+    for (int i = map->activeCount - 1; i >= 0 && budget > 0; i--) {
+        if (ChunkDistance(map->active[i], center) > ACTIVE_CHUNK_RADIUS + 1) {
+            released[releasedCount++] = map->active[i];
+            map->active[i] = map->active[--map->activeCount];
+            budget--;
+            TelemetryAdd(METRIC(METRIC_CHUNK_UNLOADS), 1);
+        }
+    }
+
+    // Park enemies outside the active area, those of unloaded chunks and
+    // stragglers, and the farthest of crowded chunks
+    ParkContext park;
+    InitParkContext(&park, map, playerPos);
+    EcsRunSystem(world, ENEMY_MASK, 0, RankSystem, &park);
+    EcsRunSystem(world, ENEMY_MASK, 0, ParkSystem, &park);
+    TelemetryAdd(METRIC(METRIC_ENEMIES_DROPPED), park.dropped);
+    TelemetrySet(METRIC(METRIC_PARKED_ENEMIES), map->header->parkedCount);
+
+    // Only now that their slots are written, drop the pages of tiles left
+    // without an active chunk
+    for (int i = 0; i < releasedCount; i++) {
+        bool tileInUse = false;
+        for (int j = 0; j < map->activeCount; j++) {
+            if (TileOffset(map->active[j]) == TileOffset(released[i])) tileInUse = true;
+        }
+        for (int j = 0; j < i; j++) {
+            if (TileOffset(released[j]) == TileOffset(released[i])) tileInUse = true;    // Already dropped
+        }
+        if (!tileInUse) {
+            msync(map->base + TileOffset(released[i]), TILE_SIZE, MS_ASYNC);
+            AdviseTile(map, released[i], MADV_DONTNEED);
+        }
+    }
+
+    // Load missing chunks, nearest rings first
+    for (int ring = 0; ring <= ACTIVE_CHUNK_RADIUS && budget > 0; ring++) {
+        for (int dz = -ring; dz <= ring && budget > 0; dz++) {
+            for (int dx = -ring; dx <= ring && budget > 0; dx++) {
+                if (abs(dx) != ring && abs(dz) != ring) continue;
+
+                ChunkCoord coord = { center.x + dx, center.z + dz };
+                if (!InWorld(coord) || FindActive(map, coord) >= 0) continue;
+                if (map->activeCount >= MAX_ACTIVE_CHUNKS) return;
+
+                UnparkChunk(map, world, coord);
+                map->active[map->activeCount++] = coord;
+                budget--;
+                TelemetryAdd(METRIC(METRIC_CHUNK_LOADS), 1);
+                TelemetrySet(METRIC(METRIC_PARKED_ENEMIES), map->header->parkedCount);
+            }
+        }
+    }
+
+    // Ask the kernel to read ahead the ring the player is heading into
+    if (moved) {
+        int ring = ACTIVE_CHUNK_RADIUS + 1;
+        for (int dz = -ring; dz <= ring; dz++) {
+            for (int dx = -ring; dx <= ring; dx++) {
+                ChunkCoord coord = { center.x + dx, center.z + dz };
+                if ((abs(dx) == ring || abs(dz) == ring) && InWorld(coord)) {
+                    AdviseTile(map, coord, MADV_WILLNEED);
+                }
+            }
+        }
+    }
+}
+
+// Outline the active chunks on the ground
+void DrawWorldMap(WorldMap *map) {
+    for (int i = 0; i < map->activeCount; i++) {
+        Vector3 origin = ChunkOrigin(map->active[i]);
+        Vector3 center = { origin.x + CHUNK_SIZE / 2, 0.0f, origin.z + CHUNK_SIZE / 2 };
+        bool inside = ChunkDistance(map->active[i], map->center) <= ACTIVE_CHUNK_RADIUS;
+
+        DrawCubeWires(center, CHUNK_SIZE, 0.0f, CHUNK_SIZE, inside ? DARKGRAY : LIGHTGRAY);
+    }
+}
@@ -0,0 +1,151 @@
+/*******************************************************************************************
+*
+*   Stats sampler
+*
+*   Reads the telemetry a running game publishes in shared memory and prints it in the
+*   Prometheus text format. The game is never paused or signalled.
+*
+*   Usage: not_working_game_stats [--pid PID] [--interval SECONDS]
+*
+********************************************************************************************/
+
+#include "telemetry.h"
+#include <dirent.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+// Unix time a process started, -1 when unknown
+static int64_t ProcessStartTime(int pid) {
+    char path[64];
+    char line[512];
+    long long bootTime = -1;
+    unsigned long long ticks = 0;
+    
+    FILE *file = fopen("/proc/stat", "r");
+    if (!file) return -1;
+    while (fgets(line, sizeof(line), file)) {
+        if (sscanf(line, "btime %lld", &bootTime) == 1) break;
+    }
+    fclose(file);
+    
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    file = fopen(path, "r");
+    if (!file) return -1;
+    bool read = fgets(line, sizeof(line), file) != NULL;
+    fclose(file);
+    
+    // Start time is the 22nd field, the 20th after the parenthesised command name
+    char *fields = read ? strrchr(line, ')') : NULL;
+    if (!fields || bootTime < 0 ||
+        sscanf(fields + 1, " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u %*d %*d %*d %*d %*d %*d %llu",
+               &ticks) != 1) {
+        return -1;
+    }
+    
+    return bootTime + (int64_t)(ticks / (unsigned long long)sysconf(_SC_CLK_TCK));
+}
+
+// Whether the process that created a game's segment still runs. A live PID
+// alone is not enough, since PIDs wrap: the process must also have started
+// no later than the segment. startTime is the segment's, -1 while the game is
+// still setting it up, in which case a live PID is given the benefit of the
+// doubt.
+static bool OwnerAlive(int pid, int64_t startTime) {
+    if (kill(pid, 0) != 0 && errno == ESRCH) return false;
+    if (startTime < 0) return true;
+    
+    // Start times are whole seconds, allow for rounding
+    int64_t processStart = ProcessStartTime(pid);
+    return processStart < 0 || processStart <= startTime + 1;
+}
+
+// Most recently started live game publishing telemetry, 0 when there is none.
+// Segments whose game died without removing them are unlinked on the way.
+static int FindGame(void) {
+    const char *prefix = TELEMETRY_SHM_PREFIX + 1;    // Segment names lose the slash under /dev/shm
+    size_t prefixLength = strlen(prefix);
+    int newest = 0;
+    int64_t newestStart = 0;
+    
+    DIR *dir = opendir("/dev/shm");
+    if (!dir) return 0;
+    
+    struct dirent *entry;
+    while ((entry = readdir(dir))) {
+        if (strncmp(entry->d_name, prefix, prefixLength) != 0) continue;
+        
+        int pid = atoi(entry->d_name + prefixLength);
+        if (pid <= 0) continue;
+        
+        // Not attachable while the game is still setting it up, so never
+        // unlinked then either
+        TelemetryRegion *region = TelemetryAttach(pid);
+        
+        if (!OwnerAlive(pid, region ? region->startTime : -1)) {
+            if (region) TelemetryDetach(region);
+            char path[64];
+            snprintf(path, sizeof(path), TELEMETRY_SHM_PREFIX "%d", pid);
+            if (shm_unlink(path) == 0) fprintf(stderr, "removed stale telemetry of process %d\n", pid);
+            continue;
+        }
+        if (!region) continue;
+        
+        int64_t start = region->startTime;
+        if (newest == 0 || start > newestStart || (start == newestStart && pid > newest)) {
+            newest = pid;
+            newestStart = start;
+        }
+        TelemetryDetach(region);
+    }
+    
+    closedir(dir);
+    return newest;
+}
+
+int main(int argc, char **argv) {
+    int pid = 0;
+    double interval = 0.0;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--interval") == 0 && i + 1 < argc) {
+            interval = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--pid") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            pid = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--pid PID] [--interval SECONDS]\n", argv[0]);
+            return 2;
+        }
+    }
+    
+    if (pid == 0) pid = FindGame();
+    if (pid == 0) {
+        fprintf(stderr, "no running game found\n");
+        return 1;
+    }
+    
+    TelemetryRegion *region = TelemetryAttach(pid);
+    if (!region) {
+        fprintf(stderr, "no telemetry published by process %d\n", pid);
+        return 1;
+    }
+    
+    // One scrape, or one every interval until the game exits
+    do {
+        TelemetryWritePrometheus(region, stdout);
+        fflush(stdout);
+        if (interval <= 0.0) break;
+        
+        struct timespec pause = { (time_t)interval, (long)((interval - (time_t)interval) * 1e9) };
+        nanosleep(&pause, NULL);
+        if (!OwnerAlive(pid, region->startTime)) break;
+        printf("\n");
+    } while (true);
+    
+    TelemetryDetach(region);
+    return 0;
+}
\ No newline at end of file